@@ -1,38 +1,199 @@
 #include "rules/ruleTemplates/serverconfigRule.hpp"
 #include "rules/objectParser.hpp"
 #include "parserExceptions.hpp"
+#include "diagnostics.hpp"
+#include "sourceCache.hpp"
 #include "../print.hpp"
 #include "config.hpp"
 
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
 #include <fstream>
-#include <variant>
+#include <thread>
+#include <atomic>
+#include <glob.h>
+
+/// @brief Hash the content of a file with 64-bit FNV-1a.
+/// @param hash The hash of the preceding content, to hash a file in parts.
+uint64_t FileFingerprint::hashContent(std::string_view content, uint64_t hash) {
+    for (unsigned char c : content) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return (hash);
+}
+
+/// @brief Get the fingerprint of a file on disk.
+/// @param previous A previous fingerprint of the same file. If its size and modification time still match,
+/// it is returned as is and the file is not read.
+/// @return The fingerprint - with exists set to false if the file cannot be read.
+FileFingerprint FileFingerprint::fromFile(const std::string &filePath, const FileFingerprint *previous) {
+    FileFingerprint fingerprint = {false, 0, 0, 0};
+    std::error_code error;
+
+    auto modifiedTime = std::filesystem::last_write_time(filePath, error);
+    if (error) return (fingerprint);
+    uintmax_t size = std::filesystem::file_size(filePath, error);
+    if (error) return (fingerprint);
+
+    fingerprint.size = size;
+    fingerprint.modifiedTime = modifiedTime.time_since_epoch().count();
+    if (previous && previous->exists && previous->size == fingerprint.size && previous->modifiedTime == fingerprint.modifiedTime)
+        return (*previous);
+
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) return (fingerprint);
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    fingerprint.exists = true;
+    fingerprint.size = content.size();
+    fingerprint.hash = hashContent(content);
+    return (fingerprint);
+}
+
+/// @brief Two fingerprints are equal if both files exist and have the same content.
+bool FileFingerprint::operator==(const FileFingerprint &other) const {
+    return (exists && other.exists && size == other.size && hash == other.hash);
+}
+
+/// @param diagnostics The sink that collects the errors of the parse, or nullptr to throw (and print) them.
+/// @param sourceCache The cache to read the files through, shared with other parsers - or nullptr to read every file from disk.
+ConfigurationParser::ConfigurationParser(LoadMode loadMode, DiagnosticSink *diagnostics, SourceCache *sourceCache)
+    : _loadMode(loadMode), _diagnostics(diagnostics), _sourceCache(sourceCache) {}
 
 ConfigFile *ConfigurationParser::_loadConfigFile(const std::string &filePath) {
-    std::fstream file(filePath);
-    if (!file.is_open())
-        throw ParserException("Failed to open configuration file: " + filePath);
+    bool streamed = (_loadMode == LoadMode::STREAMED);
+    std::shared_ptr<const SourceFile> source;
+    std::ifstream file;
+
+    // Streamed files are never read as a whole, so they bypass the source cache.
+    if (streamed)
+        file.open(filePath, std::ios::binary);
+    else if (auto prefetched = _prefetchedSources.find(filePath); prefetched != _prefetchedSources.end()) {
+        source = std::move(prefetched->second);
+        _prefetchedSources.erase(prefetched);
+    } else
+        source = _sourceCache ? _sourceCache->load(filePath) : SourceFile::read(filePath);
+    if (streamed ? !file.is_open() : !source) {
+        DiagnosticSink::report<ParserException>(_diagnostics, "Failed to open configuration file: " + filePath);
+        return (nullptr);
+    }
 
-    auto it = _configFiles.emplace(filePath, _arena.alloc<ConfigFile>(filePath, std::string(), std::vector<Token*>(), std::vector<size_t>()));
-    if (!it.second)
-        throw ParserException("Circulair import detected for: " + filePath);
+    auto it = _configFiles.emplace(filePath, _arena.alloc<ConfigFile>(filePath, std::string(), std::vector<size_t>(), &_stringPool, FileFingerprint(), streamed, _diagnostics));
+    if (!it.second) {
+        DiagnosticSink::report<ParserException>(_diagnostics, "Circulair import detected for: " + filePath);
+        return (nullptr);
+    }
     ConfigFile *configFile = it.first->second;
 
-    std::string line;
-    while (std::getline(file, line)) {
+    // The lexer computes the fingerprint and line starts while it reads the stream.
+    if (streamed) {
+        std::error_code error;
+        auto modifiedTime = std::filesystem::last_write_time(filePath, error);
+        int64_t modifiedTimeCount = error ? 0 : modifiedTime.time_since_epoch().count();
+
+        configFile->fingerprint = {true, 0, modifiedTimeCount, FileFingerprint::HASH_SEED};
+        if (Object *object = _getObjectFromFile(configFile, &file))
+            _objects[filePath] = object;
+        return (configFile);
+    }
+
+    const std::string &content = source->content;
+    configFile->fingerprint = source->fingerprint;
+
+    // Every line - including the last one - is terminated by a newline, and the content by a NUL byte.
+    configFile->fileContent.reserve(content.size() + 2);
+    for (size_t lineStart = 0; lineStart < content.size(); ) {
+        size_t lineEnd = content.find('\n', lineStart);
+        if (lineEnd == std::string::npos) lineEnd = content.size();
+
         configFile->lineStarts.push_back(configFile->fileContent.size());
-        configFile->fileContent.insert(configFile->fileContent.end(), line.begin(), line.end());
+        configFile->fileContent.append(content, lineStart, lineEnd - lineStart);
         configFile->fileContent.push_back('\n');
+        lineStart = lineEnd + 1;
     }
-
     configFile->fileContent.push_back('\0');
-    file.close();
 
-    _tokenize(configFile);
-    _objects[filePath] = _getObjectFromFile(configFile);
+    if (Object *object = _getObjectFromFile(configFile, nullptr))
+        _objects[filePath] = object;
     return (configFile);
 }
 
+/// @brief Expand a glob pattern into the files it matches, sorted by their path (byte by byte, so the order does not
+/// depend on the locale). Directories are skipped. A pattern that matches nothing is not an error.
+/// @return False if the pattern cannot be expanded.
+bool ConfigurationParser::expandPattern(const std::string &pattern, std::vector<std::string> &filePaths) {
+    glob_t matches;
+    int result = glob(pattern.c_str(), GLOB_MARK | GLOB_NOSORT, nullptr, &matches);
+
+    if (result != 0 && result != GLOB_NOMATCH) {
+        globfree(&matches);
+        return (false);
+    }
+    for (size_t i = 0; result == 0 && i < matches.gl_pathc; ++i) {
+        std::string filePath = matches.gl_pathv[i];
+        if (filePath.back() != '/')
+            filePaths.push_back(std::move(filePath));
+    }
+    globfree(&matches);
+
+    std::sort(filePaths.begin(), filePaths.end());
+    return (true);
+}
+
+/// @brief Expand the glob pattern of an include, and remember the files it matched - a file that is added later changes the configuration too.
+/// @return False if the pattern cannot be expanded - the error is reported to the diagnostic sink.
+bool ConfigurationParser::_expandIncludePattern(const std::string &pattern, std::vector<std::string> &filePaths) {
+    if (!expandPattern(pattern, filePaths)) {
+        DiagnosticSink::report<ParserException>(_diagnostics, "Failed to expand include pattern: " + pattern);
+        return (false);
+    }
+    _includePatterns[pattern] = filePaths;
+    return (true);
+}
+
+/// @brief Read files that are about to be loaded at the same time, one thread per core. _loadConfigFile() takes them
+/// from the prefetched sources instead of reading them itself, so the files are still parsed one by one, in order.
+/// @note Files that are already loaded and streamed files are not prefetched. Files that cannot be read are reported
+/// when they are loaded.
+void ConfigurationParser::_prefetchFiles(const std::vector<std::string> &filePaths) {
+    std::vector<std::string> pending;
+
+    if (_loadMode == LoadMode::STREAMED)
+        return ;
+    for (const std::string &filePath : filePaths)
+        if (_configFiles.find(filePath) == _configFiles.end() && _prefetchedSources.find(filePath) == _prefetchedSources.end())
+            pending.push_back(filePath);
+    if (pending.size() < 2)
+        return ;
+
+    std::vector<std::shared_ptr<const SourceFile>> sources(pending.size());
+    std::atomic<size_t> nextFile = 0;
+
+    auto worker = [&]() {
+        for (size_t i = nextFile++; i < pending.size(); i = nextFile++)
+            sources[i] = _sourceCache ? _sourceCache->load(pending[i]) : SourceFile::read(pending[i]);
+    };
+
+    std::vector<std::thread> threads;
+    size_t threadCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), pending.size());
+    threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    for (std::thread &thread : threads)
+        thread.join();
+
+    for (size_t i = 0; i < pending.size(); ++i)
+        if (sources[i])
+            _prefetchedSources.emplace(pending[i], std::move(sources[i]));
+}
+
+/// @brief Load and parse a configuration file, including the files it includes.
+/// @return False if the file is invalid. Without a diagnostic sink the error is printed, otherwise it is left in the sink.
 bool ConfigurationParser::parseFile(const std::string &filePath) {
+    size_t reportedErrors = DiagnosticSink::countOf(_diagnostics);
+
     if (!isFileLoaded(filePath)) {
         try {
             _loadConfigFile(filePath);
@@ -45,7 +206,7 @@ bool ConfigurationParser::parseFile(const std::string &filePath) {
         }
     }
 
-    return (true);
+    return (DiagnosticSink::countOf(_diagnostics) == reportedErrors);
 }
 
 std::vector<ServerConfig> ConfigurationParser::getResult(const std::string &filePath) {
@@ -61,7 +222,8 @@ std::vector<ServerConfig> ConfigurationParser::getResult(const std::string &file
     ObjectParser objectParser(result);
 
     try {
-        objectParser.local().required().parseRange(servers);
+        if (objectParser.local().required().parseRange(servers).failed())
+            return {};
     } catch (const ParserException &e) {
         std::cerr << e.getMessage();
         return {};
@@ -73,6 +235,106 @@ std::vector<ServerConfig> ConfigurationParser::getResult(const std::string &file
     return servers;
 }
 
+/// @brief Get the server rules of a parsed configuration file, in the same order as getResult().
+/// @note This does not build anything, so building a server from a rule can still fail.
+const Rules &ConfigurationParser::getServerRules(const std::string &filePath) const {
+    static const Rules noRules;
+
+    auto objectIt = _objects.find(filePath);
+    if (objectIt == _objects.end())
+        return (noRules);
+    auto rulesIt = objectIt->second->rules.find(Key::SERVER);
+    if (rulesIt == objectIt->second->rules.end())
+        return (noRules);
+    return (rulesIt->second);
+}
+
+/// @brief Get the parsed tree of a file, with its includes and defines resolved.
+/// @return The object of the file, or nullptr if the file was not loaded by this parser.
+const Object *ConfigurationParser::getObject(const std::string &filePath) const {
+    auto it = _objects.find(filePath);
+    return (it == _objects.end() ? nullptr : it->second);
+}
+
+/// @brief Get the fingerprints of all files that were loaded by this parser (the main files and every included file).
+std::map<std::string, FileFingerprint> ConfigurationParser::getFileFingerprints() const {
+    std::map<std::string, FileFingerprint> fingerprints;
+
+    for (const auto &[filePath, configFile] : _configFiles)
+        fingerprints.emplace(filePath, configFile->fingerprint);
+    return (fingerprints);
+}
+
+/// @brief Get the glob patterns of all includes, with the files each of them matched.
+const std::map<std::string, std::vector<std::string>> &ConfigurationParser::getIncludePatterns() const {
+    return (_includePatterns);
+}
+
+/// @brief Get the files that are directly included by a file.
+std::set<std::string> ConfigurationParser::getIncludedFiles(const std::string &filePath) const {
+    auto it = _includeGraph.find(filePath);
+    if (it == _includeGraph.end())
+        return {};
+    return (it->second);
+}
+
+/// @brief Add a file and everything it includes (recursively) to the set.
+void ConfigurationParser::_collectIncludedFiles(const std::string &filePath, std::set<std::string> &files) const {
+    if (!files.insert(filePath).second)
+        return ;
+
+    auto it = _includeGraph.find(filePath);
+    if (it == _includeGraph.end())
+        return ;
+    for (const std::string &includedFile : it->second)
+        _collectIncludedFiles(includedFile, files);
+}
+
+void ConfigurationParser::_collectDependencies(const Object *object, std::set<std::string> &files) const {
+    files.insert(object->objectOpenToken->configFile->fileName);
+
+    auto it = _objectIncludes.find(object);
+    if (it != _objectIncludes.end())
+        for (const std::string &includedFile : it->second)
+            _collectIncludedFiles(includedFile, files);
+
+    for (const auto &[key, rules] : object->rules)
+        for (const Rule *rule : rules)
+            _collectDependencies(rule, files);
+}
+
+void ConfigurationParser::_collectDependencies(const Rule *rule, std::set<std::string> &files) const {
+    files.insert(rule->token->configFile->fileName);
+    for (const Rule *includeRule : rule->includeRuleRefs)
+        files.insert(includeRule->token->configFile->fileName);
+
+    // An error page is read when the server is built, so its content is part of the result too.
+    if (rule->key == Key::ERROR_PAGE && !rule->arguments.empty() && !rule->arguments.back()->object)
+        files.insert(rule->arguments.back()->token->value);
+
+    for (const Argument *argument : rule->arguments)
+        if (argument->object)
+            _collectDependencies(argument->object, files);
+}
+
+/// @brief Get every file the result of a rule depends on: the files its own rules come from (including
+/// everything they include), the error pages it uses, and the files of the rules it can inherit from its parent scopes.
+/// @note Sibling rules of the same type (e.g. the other servers) are not part of the inherited scope.
+/// As empty included files leave no rules behind, they are covered through the include graph.
+std::set<std::string> ConfigurationParser::getDependencies(const Rule *rule) const {
+    std::set<std::string> files;
+
+    _collectDependencies(rule, files);
+    for (const Object *object = rule->parentObject; object; object = object->parentRule ? object->parentRule->parentObject : nullptr) {
+        files.insert(object->objectOpenToken->configFile->fileName);
+        for (const auto &[key, rules] : object->rules)
+            if (key != rule->key)
+                for (const Rule *inheritedRule : rules)
+                    _collectDependencies(inheritedRule, files);
+    }
+    return (files);
+}
+
 void Object::printObject(std::ostream &os, int indentLevel) const {
     for (const auto &pair : rules)
         for (const auto &rule : pair.second)
@@ -85,15 +347,15 @@ void Rule::printRule(std::ostream &os, int indentLevel) const {
     os << indent << token->value;
     for (const auto &arg : arguments) {
         os << " ";
-        lastType = arg->type;
-        if (arg->type == ArgumentType::OBJECT) {
+        lastType = arg->getType();
+        if (lastType == ArgumentType::OBJECT) {
             os << "{\n";
-            std::get<Object *>(arg->value)->printObject(os, indentLevel + 1);
+            arg->getObject()->printObject(os, indentLevel + 1);
             os << indent << "}";
-        } else if (arg->type == ArgumentType::KEYWORD) {
+        } else if (lastType == ArgumentType::KEYWORD) {
             os << TERM_COLOR_MAGENTA << arg->token->value << TERM_COLOR_RESET;
         } else {
-            os << "\"" << std::get<std::string>(arg->value) << "\"";
+            os << "\"" << arg->getString() << "\"";
         }
     }
     if (lastType != ArgumentType::OBJECT)
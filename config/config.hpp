@@ -1,18 +1,26 @@
 #pragma once
 
+#include "types/customTypes.hpp"
 #include "arena.hpp"
 
 #include <algorithm>
 #include <ostream>
-#include <variant>
+#include <any>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <cstdint>
 #include <memory>
 #include <map>
+#include <set>
 
 class ServerConfig;
 
 struct ConfigFile;
+class DiagnosticSink;
+class SourceCache;
+struct SourceFile;
+class Lexer;
 struct Argument;
 struct Token;
 struct Object;
@@ -77,27 +85,21 @@ enum Key {
 	DEFINE = 1 << 14,
 	INCLUDE = 1 << 15,
     CGI_EXTENSION = 1 << 16,
+    ERROR_PAGE_CACHE = 1 << 17,
+    SET = 1 << 18,
 };
 
 enum ArgumentType {
+	UNKNOWN_ARGUMENT = 0,
 	STRING = 1 << 0,
 	OBJECT = 1 << 1,
 	KEYWORD = 1 << 2,
 };
 
-struct TokenPattern {
-    const char *pattern;
-    size_t length;
-    TokenType type;
-};
-
-typedef std::variant<std::string, Object*, Keyword> ArgumentValue;
 typedef std::vector<Rule*> Rules;
 
-#define EOS_MASK_DEFAULT static_cast<TokenType>(~0 ^ TokenType::WEAK_STR)
 #define EOS_MASK_QUOTE(quoteType) static_cast<TokenType>(quoteType | TokenType::END)
 #define COMMENT_MASK static_cast<TokenType>(TokenType::LINE_END | TokenType::END)
-#define IS_USABLE_TOKEN_TYPE(type) ((type) & (WEAK_STR | STR | OBJECT_OPEN | OBJECT_CLOSE | RULE_END | END))
 
 struct ErrorContext {
     std::string filename;
@@ -106,18 +108,39 @@ struct ErrorContext {
     size_t columnNumber;
 };
 
+/// @brief Identifies the content of a configuration file, to detect changes between two loads.
+/// The size and modification time are only used as a shortcut: two fingerprints are equal when the content is.
+struct FileFingerprint {
+    bool exists;
+    uint64_t size;
+    int64_t modifiedTime;
+    uint64_t hash;
+
+    constexpr static uint64_t HASH_SEED = 14695981039346656037ULL;
+
+    static uint64_t hashContent(std::string_view content, uint64_t hash = HASH_SEED);
+    static FileFingerprint fromFile(const std::string &filePath, const FileFingerprint *previous = nullptr);
+
+    bool operator==(const FileFingerprint &other) const;
+};
+
 struct Token {
     TokenType type;
     std::string value;
     ConfigFile *configFile;
     size_t filePos;
+    /// The length of the token in the source, which the value no longer matches once variables are expanded.
+    size_t sourceLength;
 };
 
 struct ConfigFile {
     std::string fileName;
     std::string fileContent;
-    std::vector<Token*> tokens;
     std::vector<size_t> lineStarts;
+    StringPool *stringPool;
+    FileFingerprint fingerprint;
+    bool streamed;
+    DiagnosticSink *diagnostics;
 
     ErrorContext getErrorContext(size_t pos) const;
 };
@@ -128,6 +151,10 @@ struct Object {
     Token *objectOpenToken;
     Token *objectCloseToken;
 
+    /// The variables set in this object (without the leading '$'). They are visible in the rest of the object and in
+    /// every object nested in it - but not in included files, which have their own scope.
+    std::map<std::string, InternedString, std::less<>> variables{};
+
     void printObject(std::ostream &os, int indentLevel = 0) const;
     Object *deepCopy(Arena &arena, Rule *newParentRule) const;
 };
@@ -144,44 +171,87 @@ struct Rule {
     Rule *deepCopy(Arena &arena, Object *newParentObject) const;
 };
 
+/// @brief An argument of a rule, which only keeps the token it was parsed from (or the object it opens).
+/// Arguments are classified on first access, and the RuleParser caches the converted value in the argument -
+/// so rules that are never read (e.g. in unused defines) cost nothing, and a value is converted only once
+/// even when it is inherited by many locations.
 struct Argument {
-    ArgumentType type;
-    ArgumentValue value;
-    Rule *parentRule;
     Token *token;
+    Object *object;
+    Rule *parentRule;
+
+    mutable ArgumentType type = ArgumentType::UNKNOWN_ARGUMENT;
+    mutable Keyword keyword = Keyword::NO_KEYWORD;
+    mutable std::any converted{};
+
+    ArgumentType getType() const;
+    Keyword getKeyword() const;
+    const std::string &getString() const;
+    Object *getObject() const;
 
     Argument *deepCopy(Arena &arena, Rule *newParentRule) const;
 };
 
+/// @brief How the configuration files are read.
+enum LoadMode {
+    /// Every file is read into memory as a whole before it is parsed.
+    IN_MEMORY = 0,
+    /// Every file is lexed from a stream while it is parsed, so large files never have to be in memory as a whole.
+    /// Error messages re-read the lines they show from disk.
+    STREAMED = 1,
+};
+
 class ConfigurationParser {
 private:
+    LoadMode _loadMode;
+    DiagnosticSink *_diagnostics;
+    SourceCache *_sourceCache;
     Arena _arena;
+    StringPool _stringPool;
     std::map<std::string, Object*> _objects;
     std::map<std::string, ConfigFile*> _configFiles;
     std::vector<std::string> _includePaths;
+    std::map<std::string, std::set<std::string>> _includeGraph;
+    std::map<const Object*, std::vector<std::string>> _objectIncludes;
+    std::map<std::string, std::vector<std::string>> _includePatterns;
+    std::map<std::string, std::shared_ptr<const SourceFile>> _prefetchedSources;
 
     ConfigFile *_loadConfigFile(const std::string &filePath);
+    bool _expandIncludePattern(const std::string &pattern, std::vector<std::string> &filePaths);
+    void _prefetchFiles(const std::vector<std::string> &filePaths);
 
-    Token *getNextToken(ConfigFile *configFile, size_t &pos);
-    Token *parseContinuousToken(ConfigFile *configFile, size_t &pos, Token *currentToken, TokenType endOfStringTypeMask);
-    void _tokenize(ConfigFile *file);
-    
     void _includeObjectIntoScope(Object *object, Object *includedObject, Rule *includeRuleRef);
-    void _handleDefineRule(Rule *rule);
-    void _handleIncludeRule(ConfigFile *file, size_t &pos, Rule *rule, Object *object);
+    bool _handleDefineRule(Rule *rule);
+    bool _handleSetRule(Rule *rule, Object *object);
+    bool _expandVariables(Token *token, const Object *scope);
+    bool _handleIncludeRule(Lexer &lexer, Rule *rule, Object *object);
+    bool _includeFile(Lexer &lexer, Rule *rule, Object *object, const std::string &includePath);
+
+    Rule *_parseRule(Lexer &lexer, Object *parentObject);
+    Object *_parseObject(Lexer &lexer, Rule *parentRule);
+    Object *_getObjectFromFile(ConfigFile *file, std::istream *stream);
 
-    Rule *_parseRule(ConfigFile *file, size_t &pos, Object *parentObject);
-    Object *_parseObject(ConfigFile *file, size_t &pos, Rule *parentRule);
-    Object *_getObjectFromFile(ConfigFile *file);
+    void _collectIncludedFiles(const std::string &filePath, std::set<std::string> &files) const;
+    void _collectDependencies(const Object *object, std::set<std::string> &files) const;
+    void _collectDependencies(const Rule *rule, std::set<std::string> &files) const;
 
 public:
-    ConfigurationParser() = default;
+    ConfigurationParser(LoadMode loadMode = LoadMode::IN_MEMORY, DiagnosticSink *diagnostics = nullptr, SourceCache *sourceCache = nullptr);
     ConfigurationParser(const ConfigurationParser&) = delete;
     ConfigurationParser& operator=(const ConfigurationParser&) = delete;
     ~ConfigurationParser() = default;
 
     bool parseFile(const std::string &filePath);
     std::vector<ServerConfig> getResult(const std::string &filePath);
+    const Rules &getServerRules(const std::string &filePath) const;
+    const Object *getObject(const std::string &filePath) const;
+
+    static bool expandPattern(const std::string &pattern, std::vector<std::string> &filePaths);
+
+    std::map<std::string, FileFingerprint> getFileFingerprints() const;
+    const std::map<std::string, std::vector<std::string>> &getIncludePatterns() const;
+    std::set<std::string> getIncludedFiles(const std::string &filePath) const;
+    std::set<std::string> getDependencies(const Rule *rule) const;
 
     /// @brief Check if a file is already loaded in the lexer - even if the file is not parsed yet.
     /// @param filePath The path of the file to check.
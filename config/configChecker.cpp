@@ -0,0 +1,96 @@
+#include "rules/ruleTemplates/serverconfigRule.hpp"
+#include "configChecker.hpp"
+#include "diagnostics.hpp"
+#include "config.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <exception>
+#include <chrono>
+#include <thread>
+#include <atomic>
+
+/// @param threadCount The number of files checked at the same time, or 0 to use one thread per core.
+ConfigChecker::ConfigChecker(size_t threadCount)
+    : _threadCount(threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency())) {}
+
+/// @brief Expand a list of paths into the configuration files to check.
+/// Files are taken as they are, directories are searched recursively for .conf files (in sorted order).
+/// @note Paths that do not exist are kept, so they are reported as failed checks.
+std::vector<std::string> ConfigChecker::collectFiles(const std::vector<std::string> &paths) {
+    std::vector<std::string> files;
+
+    for (const std::string &path : paths) {
+        std::error_code error;
+        if (!std::filesystem::is_directory(path, error)) {
+            files.push_back(path);
+            continue;
+        }
+
+        std::vector<std::string> directoryFiles;
+        for (auto it = std::filesystem::recursive_directory_iterator(path, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+            if (it->is_regular_file(error) && it->path().extension() == ".conf")
+                directoryFiles.push_back(it->path().string());
+        std::sort(directoryFiles.begin(), directoryFiles.end());
+        files.insert(files.end(), directoryFiles.begin(), directoryFiles.end());
+    }
+    return (files);
+}
+
+/// @brief Parse a file and build all its servers, collecting the errors instead of printing them.
+CheckResult ConfigChecker::_check(const std::string &filePath) {
+    using Clock = std::chrono::steady_clock;
+    CheckResult result = {filePath, false, 0, 0, 0, {}};
+    DiagnosticSink diagnostics;
+
+    try {
+        ConfigurationParser parser(LoadMode::IN_MEMORY, &diagnostics, &_sourceCache);
+
+        Clock::time_point start = Clock::now();
+        bool parsed = parser.parseFile(filePath);
+        Clock::time_point parsedAt = Clock::now();
+        result.parseMilliseconds = std::chrono::duration<double, std::milli>(parsedAt - start).count();
+
+        if (parsed) {
+            std::vector<ServerConfig> servers = parser.getResult(filePath);
+            result.buildMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - parsedAt).count();
+            result.serverCount = servers.size();
+            if (servers.empty() && diagnostics.empty())
+                result.errors.push_back({"No server defined in " + filePath, "", {}});
+        }
+
+        for (const std::unique_ptr<ParserException> &diagnostic : diagnostics.getDiagnostics())
+            result.errors.push_back({diagnostic->what(), diagnostic->getLocation(), diagnostic->getCompactTraceback()});
+    } catch (const std::exception &e) {
+        result.errors.push_back({"Exception while checking configuration: " + std::string(e.what()), "", {}});
+    }
+
+    result.passed = result.errors.empty();
+    return (result);
+}
+
+/// @brief Check every file on the thread pool. Blocks until all files are checked.
+/// @return The results, in the same order as the files.
+std::vector<CheckResult> ConfigChecker::checkAll(const std::vector<std::string> &filePaths) {
+    std::vector<CheckResult> results(filePaths.size());
+    std::atomic<size_t> nextFile = 0;
+
+    auto worker = [&]() {
+        for (size_t i = nextFile++; i < filePaths.size(); i = nextFile++)
+            results[i] = _check(filePaths[i]);
+    };
+
+    std::vector<std::thread> threads;
+    size_t threadCount = std::min(_threadCount, filePaths.size());
+    threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    for (std::thread &thread : threads)
+        thread.join();
+
+    return (results);
+}
+
+size_t ConfigChecker::getThreadCount() const {
+    return (_threadCount);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "sourceCache.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/// @brief A single error found while checking a configuration file.
+struct CheckError {
+    std::string message;
+    /// "file:line:column" of the offending token, empty if the error has no location.
+    std::string location;
+    /// The include rules that led to the file of the error, innermost first, as "file:line: rule".
+    std::vector<std::string> traceback;
+};
+
+/// @brief The outcome of checking a single configuration file.
+struct CheckResult {
+    std::string filePath;
+    bool passed;
+    size_t serverCount;
+    double parseMilliseconds;
+    double buildMilliseconds;
+    std::vector<CheckError> errors;
+};
+
+/// @brief Validates many configuration files at once, for example every per-environment configuration before a deploy.
+/// The files are parsed and built on a pool of threads, every file with its own parser and diagnostic sink -
+/// only the source cache is shared, so files that are included by many configurations are read once.
+class ConfigChecker {
+private:
+    size_t _threadCount;
+    SourceCache _sourceCache;
+
+    CheckResult _check(const std::string &filePath);
+
+public:
+    ConfigChecker(size_t threadCount = 0);
+    ConfigChecker(const ConfigChecker&) = delete;
+    ConfigChecker& operator=(const ConfigChecker&) = delete;
+    ~ConfigChecker() = default;
+
+    static std::vector<std::string> collectFiles(const std::vector<std::string> &paths);
+
+    std::vector<CheckResult> checkAll(const std::vector<std::string> &filePaths);
+    size_t getThreadCount() const;
+};
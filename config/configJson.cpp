@@ -0,0 +1,124 @@
+#include "rules/ruleTemplates/serverconfigRule.hpp"
+#include "rules/ruleTemplates/locationRule.hpp"
+#include "configJson.hpp"
+
+#include <algorithm>
+
+/// @brief Get the line of a token, without reading the line itself like ConfigFile::getErrorContext does.
+static size_t lineOf(const Token *token) {
+    const std::vector<size_t> &lineStarts = token->configFile->lineStarts;
+    return (std::distance(lineStarts.begin(), std::lower_bound(lineStarts.begin(), lineStarts.end(), token->filePos + 1)));
+}
+
+static void writeMethods(JsonWriter &json, Method methods) {
+    static const Method allMethods[] = {GET, POST, DELETE, PUT, HEAD, OPTIONS};
+
+    json.beginArray();
+    for (Method method : allMethods)
+        if (methods & method)
+            json.string(methodToStr(method));
+    json.endArray();
+}
+
+void writeJson(JsonWriter &json, const ServerConfig &server) {
+    json.beginObject();
+    json.key("listen").number(server.port.getPort().value);
+    json.key("default_server").boolean(server.port.isDefault());
+    json.key("server_name").string(server.serverName.getServerName());
+
+    json.key("locations").beginArray();
+    for (const LocationRule &location : server.getLocations())
+        writeJson(json, location);
+    json.endArray();
+
+    json.key("default_location");
+    writeJson(json, server.getDefaultLocation());
+    json.endObject();
+}
+
+void writeJson(JsonWriter &json, const LocationRule &location) {
+    const LocationColdRules &cold = location.cold();
+
+    json.beginObject();
+    json.key("path").string(location.path.str());
+    json.key("modifier").string(location.modifier == LocationModifier::PREFIX_MATCH ? "" : locationModifierToStr(location.modifier));
+    json.key("methods");
+    writeMethods(json, location.methods.getMethods());
+    json.key("root").string(location.root.getRootPath().str());
+
+    json.key("upload_dir");
+    if (cold.uploadStore.isSet())
+        json.string(cold.uploadStore.getUploadDir().str());
+    else
+        json.null();
+
+    json.key("autoindex").boolean(cold.autoIndex.get());
+
+    json.key("index").beginArray();
+    for (const InternedString &file : cold.index.getIndexFiles())
+        json.string(file.str());
+    json.endArray();
+
+    json.key("return");
+    if (location.returnRule.isSet()) {
+        json.beginObject();
+        json.key("code").number(location.returnRule.getStatusCode().value);
+        json.key("parameter").string(location.returnRule.getParameter());
+        json.endObject();
+    } else
+        json.null();
+
+    json.key("error_pages").beginObject();
+    for (const auto &[code, page] : cold.errorPages.getErrorPages()) {
+        char digits[8];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), code.value);
+        json.key(code.value == StatusCode::Wildcard().value ? std::string_view("*") : std::string_view(digits, result.ptr - digits));
+        json.string(page.str());
+    }
+    json.endObject();
+
+    json.key("error_page_cache").boolean(cold.errorPageCache.isEnabled());
+    json.key("max_body_size").number(cold.maxBodySize.getMaxBodySize().get());
+    json.key("cgi").boolean(location.cgi.isEnabled());
+    json.key("cgi_timeout").number(cold.cgiTimeout.timeout.getSeconds());
+
+    json.key("cgi_extensions").beginObject();
+    for (const CgiExtension &extension : cold.cgiExtention.getExtensions())
+        json.key(extension.extension.str()).string(extension.interpreter.str());
+    json.endObject();
+    json.endObject();
+}
+
+void writeJson(JsonWriter &json, const Object &object) {
+    json.beginObject();
+    json.key("rules").beginArray();
+    for (const auto &[key, rules] : object.rules)
+        for (const Rule *rule : rules)
+            writeJson(json, *rule);
+    json.endArray();
+    json.endObject();
+}
+
+void writeJson(JsonWriter &json, const Rule &rule) {
+    json.beginObject();
+    json.key("name").string(rule.token->value);
+    json.key("file").string(rule.token->configFile->fileName);
+    json.key("line").number(lineOf(rule.token));
+
+    json.key("arguments").beginArray();
+    for (const Argument *argument : rule.arguments) {
+        if (argument->getType() == ArgumentType::OBJECT)
+            writeJson(json, *argument->getObject());
+        else
+            json.string(argument->getString());
+    }
+    json.endArray();
+
+    if (!rule.includeRuleRefs.empty()) {
+        json.key("included_from").beginArray();
+        for (const Rule *includeRule : rule.includeRuleRefs)
+            json.string(includeRule->arguments[0]->getString());
+        json.endArray();
+    }
+    json.endObject();
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "jsonWriter.hpp"
+#include "config.hpp"
+
+class ServerConfig;
+class LocationRule;
+
+/// @brief Serializers for the resolved configuration (ServerConfig, LocationRule) and for the parsed tree (Object, Rule).
+/// The resolved form has one key per directive with its effective value, so inherited values are written for every location.
+/// The tree form keeps the rules as written, with their file, line and the include rules they came through.
+
+void writeJson(JsonWriter &json, const ServerConfig &server);
+void writeJson(JsonWriter &json, const LocationRule &location);
+void writeJson(JsonWriter &json, const Object &object);
+void writeJson(JsonWriter &json, const Rule &rule);
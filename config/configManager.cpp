@@ -0,0 +1,239 @@
+#include "configManager.hpp"
+#include "../print.hpp"
+#include "parserExceptions.hpp"
+#include "diagnostics.hpp"
+#include "config.hpp"
+
+#include <utility>
+
+std::atomic<uint64_t> ConfigManager::_nextId = 1;
+
+/// @brief Create a manager for a configuration file. Nothing is parsed yet - call reload() for the initial load.
+/// @param filePath The path of the main configuration file.
+ConfigManager::ConfigManager(const std::string &filePath)
+    : _id(_nextId.fetch_add(1, std::memory_order_relaxed)), _filePath(filePath), _snapshot(nullptr), _epoch(0),
+    _reloadThread(&ConfigManager::_reloadLoop, this) {}
+
+ConfigManager::~ConfigManager() {
+    {
+        std::lock_guard<std::mutex> lock(_requestMutex);
+        _stopping = true;
+    }
+    _requestCondition.notify_one();
+    _reloadThread.join();
+}
+
+/// @brief Check if any file of a snapshot changed on disk since it was parsed, or if an include pattern matches other files now.
+/// A file that did not exist (an error page that is not created yet) has only changed once it exists.
+bool ConfigManager::_hasChanged(const ConfigSnapshot &snapshot) {
+    for (const auto &[filePath, fingerprint] : snapshot.files) {
+        FileFingerprint current = FileFingerprint::fromFile(filePath, &fingerprint);
+        if (current.exists != fingerprint.exists || (current.exists && !(current == fingerprint)))
+            return (true);
+    }
+
+    for (const auto &[pattern, matchedFiles] : snapshot.includePatterns) {
+        std::vector<std::string> filePaths;
+        if (!ConfigurationParser::expandPattern(pattern, filePaths) || filePaths != matchedFiles)
+            return (true);
+    }
+    return (false);
+}
+
+/// @brief Log the errors of an invalid configuration through the logger, so they follow the log level like every other message.
+void ConfigManager::_logDiagnostics(const DiagnosticSink &diagnostics) {
+    for (const std::unique_ptr<ParserException> &diagnostic : diagnostics.getDiagnostics())
+        ERROR(diagnostic->getMessage());
+}
+
+/// @brief Build a key that identifies the exact content of a set of files.
+/// Two servers with the same key are built from the same rules, so one can replace the other.
+std::string ConfigManager::_dependencyKey(const std::set<std::string> &dependencies, const std::map<std::string, FileFingerprint> &files) {
+    std::string key;
+
+    for (const std::string &filePath : dependencies) {
+        auto it = files.find(filePath);
+        uint64_t hash = (it != files.end()) ? it->second.hash : 0;
+
+        key += filePath;
+        key += '\0';
+        key.append(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    }
+    return (key);
+}
+
+/// @brief Parse the configuration file with a fresh parser.
+/// Servers are only rebuilt if one of the files they depend on changed, the others are taken over from the previous snapshot.
+/// @param previous The active snapshot, or nullptr for the initial load.
+/// @return The new snapshot, the previous snapshot if no file changed, or nullptr if the configuration is invalid.
+std::shared_ptr<const ConfigSnapshot> ConfigManager::_parse(uint64_t generation, const std::shared_ptr<const ConfigSnapshot> &previous) const {
+    if (previous && !_hasChanged(*previous))
+        return (previous);
+
+    DiagnosticSink diagnostics;
+    ConfigurationParser parser(LoadMode::IN_MEMORY, &diagnostics);
+    if (!parser.parseFile(_filePath)) {
+        _logDiagnostics(diagnostics);
+        return (nullptr);
+    }
+
+    const Rules &serverRules = parser.getServerRules(_filePath);
+    if (serverRules.empty()) {
+        ERROR("No server defined in " << _filePath);
+        return (nullptr);
+    }
+
+    std::shared_ptr<ConfigSnapshot> snapshot = std::make_shared<ConfigSnapshot>();
+    snapshot->files = parser.getFileFingerprints();
+    snapshot->includePatterns = parser.getIncludePatterns();
+    snapshot->filePath = _filePath;
+    snapshot->generation = generation;
+
+    std::multimap<std::string, size_t> reusableServers;
+    if (previous)
+        for (size_t i = 0; i < previous->servers.size(); ++i)
+            reusableServers.emplace(previous->serverDependencies[i], i);
+
+    size_t reusedCount = 0;
+    snapshot->servers.reserve(serverRules.size());
+    snapshot->serverDependencies.reserve(serverRules.size());
+    try {
+        for (Rule *rule : serverRules) {
+            // The parser only knows the configuration files - the other dependencies (error pages) are fingerprinted here.
+            std::set<std::string> dependencies = parser.getDependencies(rule);
+            for (const std::string &filePath : dependencies) {
+                if (snapshot->files.count(filePath))
+                    continue;
+                const FileFingerprint *known = nullptr;
+                if (previous) {
+                    auto it = previous->files.find(filePath);
+                    known = (it != previous->files.end()) ? &it->second : nullptr;
+                }
+                snapshot->files.emplace(filePath, FileFingerprint::fromFile(filePath, known));
+            }
+            std::string key = _dependencyKey(dependencies, snapshot->files);
+
+            auto it = reusableServers.find(key);
+            if (it != reusableServers.end()) {
+                snapshot->servers.push_back(previous->servers[it->second]);
+                reusableServers.erase(it);
+                ++reusedCount;
+            } else
+                snapshot->servers.push_back(std::make_shared<const ServerConfig>(rule));
+            snapshot->serverDependencies.push_back(std::move(key));
+
+            if (!diagnostics.empty()) {
+                _logDiagnostics(diagnostics);
+                return (nullptr);
+            }
+        }
+    } catch (const std::exception &e) {
+        ERROR("Exception while processing configuration: " + std::string(e.what()));
+        return (nullptr);
+    }
+
+    DEBUG("Reused " << reusedCount << " of " << snapshot->servers.size() << " servers from the previous configuration");
+    return (snapshot);
+}
+
+/// @brief Wait for reload requests and handle them one at a time.
+/// Requests that arrive while a reload is running are merged into a single reload afterwards.
+void ConfigManager::_reloadLoop() {
+    std::unique_lock<std::mutex> lock(_requestMutex);
+
+    while (true) {
+        _requestCondition.wait(lock, [this] { return (_reloadRequested || _stopping); });
+        if (_stopping)
+            return ;
+
+        _reloadRequested = false;
+        lock.unlock();
+        reload();
+        lock.lock();
+    }
+}
+
+/// @brief Parse the configuration file and publish it if it is valid. Blocks until the reload is done.
+/// @return True if the new configuration is active, false if the previous one was kept.
+bool ConfigManager::reload() {
+    std::lock_guard<std::mutex> lock(_reloadMutex);
+
+    // Only reload() replaces the snapshot, and it holds the reload lock.
+    std::shared_ptr<const ConfigSnapshot> previous = _snapshot;
+    std::shared_ptr<const ConfigSnapshot> snapshot = _parse(_generation + 1, previous);
+    if (!snapshot) {
+        ERROR("Reloading " << _filePath << " failed, keeping configuration generation " << _generation);
+        return (false);
+    }
+    if (snapshot == previous) {
+        DEBUG("Configuration " << _filePath << " did not change, keeping generation " << _generation);
+        return (true);
+    }
+
+    _generation = snapshot->generation;
+    {
+        std::lock_guard<std::mutex> publishLock(_publishMutex);
+        _snapshot = std::move(snapshot);
+        _epoch.store(_generation, std::memory_order_release);
+    }
+    DEBUG("Published configuration generation " << _generation << " of " << _filePath);
+
+    std::lock_guard<std::mutex> listenerLock(_listenerMutex);
+    for (const auto &[listenerId, listener] : _publishListeners)
+        listener(*_snapshot);
+    return (true);
+}
+
+/// @brief Call a function every time a new configuration is published, from the thread that reloaded it.
+/// The listener must not block and must not reload the configuration itself.
+/// @return The id of the listener, to remove it again.
+size_t ConfigManager::addPublishListener(std::function<void(const ConfigSnapshot&)> listener) {
+    std::lock_guard<std::mutex> lock(_listenerMutex);
+
+    _publishListeners.emplace(_nextListenerId, std::move(listener));
+    return (_nextListenerId++);
+}
+
+/// @brief Stop calling a listener. Once this returns the listener is not running and will not be called again.
+void ConfigManager::removePublishListener(size_t listenerId) {
+    std::lock_guard<std::mutex> lock(_listenerMutex);
+    _publishListeners.erase(listenerId);
+}
+
+/// @brief Ask the background thread to reload the configuration. Returns immediately.
+void ConfigManager::requestReload() {
+    {
+        std::lock_guard<std::mutex> lock(_requestMutex);
+        _reloadRequested = true;
+    }
+    _requestCondition.notify_one();
+}
+
+/// @brief Get the active configuration. While no new configuration was published this only checks the epoch:
+/// the snapshot comes from the cache of the calling thread, without taking a lock or touching its reference count.
+/// @return The active snapshot, or nullptr if no configuration was loaded successfully yet. The reference is valid until the
+/// calling thread reads a snapshot again (from any manager) - copy it to keep the snapshot alive beyond that.
+const std::shared_ptr<const ConfigSnapshot> &ConfigManager::getSnapshot() const {
+    static thread_local CachedSnapshot cache;
+
+    if (cache.manager != _id || cache.epoch != _epoch.load(std::memory_order_acquire)) {
+        // Declared before the lock, so an old snapshot is freed after the lock is released.
+        std::shared_ptr<const ConfigSnapshot> previous;
+        std::lock_guard<std::mutex> lock(_publishMutex);
+
+        previous = std::exchange(cache.snapshot, _snapshot);
+        cache.manager = _id;
+        cache.epoch = _epoch.load(std::memory_order_relaxed);
+    }
+    return (cache.snapshot);
+}
+
+/// @brief Get the generation of the active configuration - it is increased by every successful reload.
+uint64_t ConfigManager::getGeneration() const {
+    return (_epoch.load(std::memory_order_acquire));
+}
+
+/// @brief Get the path of the main configuration file.
+const std::string &ConfigManager::getFilePath() const {
+    return (_filePath);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "rules/ruleTemplates/serverconfigRule.hpp"
+#include "config.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+#include <thread>
+#include <memory>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <map>
+#include <set>
+
+/// @brief A fully parsed and validated configuration. Once published a snapshot is never modified,
+/// so any number of threads can read it without locking.
+/// Servers are shared between snapshots: a reload reuses every server whose files did not change.
+struct ConfigSnapshot {
+    std::vector<std::shared_ptr<const ServerConfig>> servers;
+    std::vector<std::string> serverDependencies;
+    std::map<std::string, FileFingerprint> files;
+    /// The glob patterns of the includes, with the files they matched - a file that is added or removed changes the configuration.
+    std::map<std::string, std::vector<std::string>> includePatterns;
+    std::string filePath;
+    uint64_t generation;
+};
+
+/// @brief Owns the active configuration and replaces it while the server keeps running.
+/// Readers get the current snapshot through a per-thread cache: a reader only checks the epoch of the manager (one atomic load
+/// of a value that only changes on reload) and keeps using the snapshot its thread already holds while the epoch is unchanged.
+/// Only the first read of a thread after a reload takes the publish lock and a reference to the new snapshot, so readers never
+/// contend on a lock or a shared reference count. An old snapshot is freed once every thread that read it has moved on.
+/// Reloads are parsed in a background thread; when the new configuration is invalid the old one stays active.
+class ConfigManager {
+private:
+    /// @brief The snapshot that a thread read last, and the manager and epoch it was read from.
+    struct CachedSnapshot {
+        uint64_t manager = 0;
+        uint64_t epoch = 0;
+        std::shared_ptr<const ConfigSnapshot> snapshot;
+    };
+
+    static std::atomic<uint64_t> _nextId;
+
+    const uint64_t _id;
+    std::string _filePath;
+
+    mutable std::mutex _publishMutex;
+    /// The active snapshot, guarded by _publishMutex. Only reload() replaces it.
+    std::shared_ptr<const ConfigSnapshot> _snapshot;
+    /// The generation of the active snapshot, published after it - a reader whose cached epoch differs takes the lock.
+    std::atomic<uint64_t> _epoch;
+    uint64_t _generation = 0;
+
+    std::mutex _listenerMutex;
+    std::map<size_t, std::function<void(const ConfigSnapshot&)>> _publishListeners;
+    size_t _nextListenerId = 0;
+
+    std::mutex _reloadMutex;
+    std::mutex _requestMutex;
+    std::condition_variable _requestCondition;
+    bool _reloadRequested = false;
+    bool _stopping = false;
+    std::thread _reloadThread;
+
+    static bool _hasChanged(const ConfigSnapshot &snapshot);
+    static void _logDiagnostics(const DiagnosticSink &diagnostics);
+    static std::string _dependencyKey(const std::set<std::string> &dependencies, const std::map<std::string, FileFingerprint> &files);
+    std::shared_ptr<const ConfigSnapshot> _parse(uint64_t generation, const std::shared_ptr<const ConfigSnapshot> &previous) const;
+    void _reloadLoop();
+
+public:
+    ConfigManager(const std::string &filePath);
+    ConfigManager(const ConfigManager&) = delete;
+    ConfigManager& operator=(const ConfigManager&) = delete;
+    ~ConfigManager();
+
+    bool reload();
+    void requestReload();
+
+    size_t addPublishListener(std::function<void(const ConfigSnapshot&)> listener);
+    void removePublishListener(size_t listenerId);
+
+    const std::shared_ptr<const ConfigSnapshot> &getSnapshot() const;
+    uint64_t getGeneration() const;
+    const std::string &getFilePath() const;
+};
@@ -0,0 +1,210 @@
+#ifdef __linux__
+
+#include "configWatcher.hpp"
+#include "../print.hpp"
+
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <filesystem>
+#include <unistd.h>
+#include <cstring>
+#include <algorithm>
+#include <fnmatch.h>
+#include <cerrno>
+#include <poll.h>
+
+#define CONFIG_WATCHER_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE)
+#define CONFIG_WATCHER_LISTING_EVENTS (IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE)
+
+ConfigWatcher::ConfigWatcher(ConfigManager &manager, std::chrono::milliseconds debounce)
+    : _manager(manager), _debounce(debounce) {}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+}
+
+/// @brief Get the directory that has to be watched for a file.
+std::string ConfigWatcher::_directoryOf(const std::string &filePath) {
+    std::filesystem::path directory = std::filesystem::path(filePath).parent_path();
+    return (directory.empty() ? "." : directory.string());
+}
+
+/// @brief Normalize a file path, so the paths of the configuration can be compared with the paths of the events.
+std::string ConfigWatcher::_normalize(const std::string &filePath) {
+    return (std::filesystem::path(filePath).lexically_normal().string());
+}
+
+/// @brief Check if a path contains glob characters.
+bool ConfigWatcher::_isPattern(const std::string &path) {
+    return (path.find_first_of("*?[") != std::string::npos);
+}
+
+/// @brief Start watching the configuration in a background thread.
+/// @return False if inotify could not be set up - the configuration is then only reloaded on request.
+bool ConfigWatcher::start() {
+    if (_thread.joinable())
+        return (true);
+
+    _inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    _wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    _publishFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_inotifyFd < 0 || _wakeFd < 0 || _publishFd < 0) {
+        ERROR("Failed to watch the configuration: " << std::strerror(errno));
+        stop();
+        return (false);
+    }
+
+    // Every published configuration (also when it was not reloaded by this watcher) may include other files.
+    // Listening before the first sync means that a configuration published in between is not missed.
+    _publishListener = _manager.addPublishListener([this](const ConfigSnapshot &) { _signal(_publishFd); });
+    _listening = true;
+    _syncWatches();
+    _thread = std::thread(&ConfigWatcher::_run, this);
+    return (true);
+}
+
+/// @brief Stop watching the configuration. Waits for a running reload to finish.
+void ConfigWatcher::stop() {
+    if (_listening)
+        _manager.removePublishListener(_publishListener);
+    _listening = false;
+    if (_thread.joinable()) {
+        _signal(_wakeFd);
+        _thread.join();
+    }
+
+    if (_inotifyFd >= 0) close(_inotifyFd);
+    if (_wakeFd >= 0) close(_wakeFd);
+    if (_publishFd >= 0) close(_publishFd);
+    _inotifyFd = -1;
+    _wakeFd = -1;
+    _publishFd = -1;
+    _watchedDirectories.clear();
+    _watchedFiles.clear();
+    _watchedPatterns.clear();
+}
+
+/// @brief Wake up the watcher thread through one of its eventfds.
+void ConfigWatcher::_signal(int eventFd) {
+    uint64_t value = 1;
+
+    if (write(eventFd, &value, sizeof(value)) < 0)
+        ERROR("Failed to wake up the configuration watcher: " << std::strerror(errno));
+}
+
+/// @brief Watch the directories of every file and include pattern in the active configuration, and stop watching the
+/// directories that are no longer used. A pattern with glob characters in its directory only relies on the directories of the
+/// files it matched. Without an active configuration only the main file is watched, so fixing a broken configuration still
+/// triggers a reload.
+void ConfigWatcher::_syncWatches() {
+    std::shared_ptr<const ConfigSnapshot> snapshot = _manager.getSnapshot();
+    std::set<std::string> directories;
+
+    _watchedFiles.clear();
+    _watchedPatterns.clear();
+    _watchedFiles.insert(_normalize(_manager.getFilePath()));
+    if (snapshot) {
+        for (const auto &[filePath, fingerprint] : snapshot->files)
+            _watchedFiles.insert(_normalize(filePath));
+        for (const auto &[pattern, matchedFiles] : snapshot->includePatterns)
+            _watchedPatterns.insert(_normalize(pattern));
+    }
+    for (const std::string &filePath : _watchedFiles)
+        directories.insert(_directoryOf(filePath));
+    for (const std::string &pattern : _watchedPatterns)
+        if (!_isPattern(_directoryOf(pattern)))
+            directories.insert(_directoryOf(pattern));
+
+    for (auto it = _watchedDirectories.begin(); it != _watchedDirectories.end(); ) {
+        if (directories.erase(it->second) == 0) {
+            inotify_rm_watch(_inotifyFd, it->first);
+            it = _watchedDirectories.erase(it);
+        } else
+            ++it;
+    }
+
+    for (const std::string &directory : directories) {
+        int watchFd = inotify_add_watch(_inotifyFd, directory.c_str(), CONFIG_WATCHER_EVENTS | IN_ONLYDIR);
+        if (watchFd < 0)
+            ERROR("Failed to watch directory " << directory << ": " << std::strerror(errno));
+        else
+            _watchedDirectories[watchFd] = directory;
+    }
+}
+
+/// @brief Read all pending inotify events.
+/// @return True if one of the events concerns a file of the configuration, or adds or removes a file that an include pattern matches.
+bool ConfigWatcher::_readEvents() {
+    alignas(struct inotify_event) char buffer[4096];
+    bool changed = false;
+
+    while (true) {
+        ssize_t length = read(_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0)
+            break ;
+
+        for (ssize_t offset = 0; offset < length; ) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                changed = true;
+                continue;
+            }
+            auto it = _watchedDirectories.find(event->wd);
+            if (it == _watchedDirectories.end() || event->len == 0)
+                continue;
+            std::string filePath = _normalize(it->second + "/" + event->name);
+            if (_watchedFiles.count(filePath))
+                changed = true;
+            else if (event->mask & CONFIG_WATCHER_LISTING_EVENTS) {
+                for (const std::string &pattern : _watchedPatterns)
+                    if (fnmatch(pattern.c_str(), filePath.c_str(), FNM_PATHNAME | FNM_PERIOD) == 0)
+                        changed = true;
+            }
+        }
+    }
+    return (changed);
+}
+
+/// @brief Wait for changes and reload the configuration once the changes have settled.
+void ConfigWatcher::_run() {
+    struct pollfd fds[3] = {{_inotifyFd, POLLIN, 0}, {_wakeFd, POLLIN, 0}, {_publishFd, POLLIN, 0}};
+    std::chrono::steady_clock::time_point deadline;
+    bool pending = false;
+
+    while (true) {
+        int timeout = -1;
+        if (pending) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            timeout = std::max(0, static_cast<int>(remaining.count()));
+        }
+
+        if (poll(fds, 3, timeout) < 0) {
+            if (errno == EINTR)
+                continue;
+            ERROR("Failed to wait for configuration changes: " << std::strerror(errno));
+            return ;
+        }
+        if (fds[1].revents & POLLIN)
+            return ;
+
+        if ((fds[0].revents & POLLIN) && _readEvents()) {
+            pending = true;
+            deadline = std::chrono::steady_clock::now() + _debounce;
+        }
+
+        if (pending && std::chrono::steady_clock::now() >= deadline) {
+            pending = false;
+            DEBUG("Configuration files changed, reloading " << _manager.getFilePath());
+            _manager.reload();
+        }
+
+        // A configuration was published: the set of files changes when includes are added or removed.
+        uint64_t published;
+        if ((fds[2].revents & POLLIN) && read(_publishFd, &published, sizeof(published)) > 0)
+            _syncWatches();
+    }
+}
+
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+
+#ifdef __linux__
+
+#include "configManager.hpp"
+
+#include <cstdint>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <map>
+#include <set>
+
+/// @brief Watches every file of the active configuration with inotify and reloads the configuration when one changes.
+/// Editors often write a file in several steps (truncate, write, rename over the original), so changes are debounced:
+/// the reload only starts once no watched file changed for the debounce interval.
+/// @note The directories of the files are watched instead of the files themselves, so a file that is
+/// replaced through a rename is still noticed. The directories of glob includes are watched as well, so a file that is
+/// added to or removed from an included directory is noticed too.
+class ConfigWatcher {
+private:
+    ConfigManager &_manager;
+    std::chrono::milliseconds _debounce;
+
+    int _inotifyFd = -1;
+    int _wakeFd = -1;
+    int _publishFd = -1;
+    size_t _publishListener = 0;
+    bool _listening = false;
+    std::map<int, std::string> _watchedDirectories;
+    std::set<std::string> _watchedFiles;
+    std::set<std::string> _watchedPatterns;
+    std::thread _thread;
+
+    static std::string _directoryOf(const std::string &filePath);
+    static std::string _normalize(const std::string &filePath);
+    static bool _isPattern(const std::string &path);
+
+    static void _signal(int eventFd);
+
+    void _syncWatches();
+    bool _readEvents();
+    void _run();
+
+public:
+    ConfigWatcher(ConfigManager &manager, std::chrono::milliseconds debounce = std::chrono::milliseconds(200));
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+    ~ConfigWatcher();
+
+    bool start();
+    void stop();
+};
+
+#endif
@@ -0,0 +1,442 @@
+#include "rules/ruleTemplates/serverconfigRule.hpp"
+#include "types/regexAutomaton.hpp"
+#include "cppEmitter.hpp"
+
+#include <charconv>
+#include <memory>
+#include <map>
+#include <set>
+
+namespace {
+
+/// @brief A node of the prefix tree of a server: one character per node, compressed into runs when emitted.
+struct PrefixNode {
+    long location = -1;
+    std::map<char, std::unique_ptr<PrefixNode>> children;
+};
+
+/// @brief The generated error page tables, by the pages they were generated from.
+typedef std::map<std::vector<std::pair<int, std::string>>, std::string> ErrorPageTables;
+
+/// @brief The names of the generated tables that belong to one location.
+struct LocationTables {
+    std::string indexFiles;
+    std::string cgiExtensions;
+    std::string errorPages;
+};
+
+}
+
+/// @brief Quote a string as a C++ string literal. Non-printable characters are written as three-digit octal escapes,
+/// which - unlike hex escapes - cannot swallow the characters that follow them.
+static std::string cppString(std::string_view str) {
+    static const char octalDigits[] = "01234567";
+    std::string quoted = "\"";
+
+    for (unsigned char c : str) {
+        if (c == '"' || c == '\\') {
+            quoted.push_back('\\');
+            quoted.push_back(static_cast<char>(c));
+        } else if (c < 0x20 || c >= 0x7f) {
+            quoted.push_back('\\');
+            quoted.push_back(octalDigits[(c >> 6) & 7]);
+            quoted.push_back(octalDigits[(c >> 3) & 7]);
+            quoted.push_back(octalDigits[c & 7]);
+        } else
+            quoted.push_back(static_cast<char>(c));
+    }
+    quoted.push_back('"');
+    return (quoted);
+}
+
+static std::string cppChar(char c) {
+    if (c == '\'' || c == '\\')
+        return (std::string("'\\") + c + "'");
+    if (static_cast<unsigned char>(c) < 0x20 || static_cast<unsigned char>(c) >= 0x7f)
+        return ("static_cast<char>(" + std::to_string(static_cast<unsigned char>(c)) + ")");
+    return (std::string("'") + c + "'");
+}
+
+static std::string cppDouble(double value) {
+    char digits[32];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    std::string str(digits, result.ptr);
+
+    if (str.find_first_of(".e") == std::string::npos)
+        str += ".0";
+    return (str);
+}
+
+/// @brief Emit the matcher of the regex locations: the automaton of the parser (see RegexAutomaton) as constant tables,
+/// simulated in a single pass over the URL without recursion.
+static void emitRegexMatcher(std::ostream &os) {
+    os << "inline constexpr uint8_t REGEX_CHAR_CLASS = " << static_cast<int>(RegexAutomaton::CHAR_CLASS) << ";\n"
+       << "inline constexpr uint8_t REGEX_SPLIT = " << static_cast<int>(RegexAutomaton::SPLIT) << ";\n"
+       << "inline constexpr uint8_t REGEX_MATCH = " << static_cast<int>(RegexAutomaton::MATCH) << ";\n"
+       << "inline constexpr uint8_t REGEX_ASSERT_BEGIN = " << static_cast<int>(RegexAutomaton::ASSERT_BEGIN) << ";\n"
+       << "inline constexpr uint8_t REGEX_ASSERT_END = " << static_cast<int>(RegexAutomaton::ASSERT_END) << ";\n"
+       << "inline constexpr uint8_t REGEX_WORD_BOUNDARY = " << static_cast<int>(RegexAutomaton::WORD_BOUNDARY) << ";\n"
+       << "inline constexpr uint8_t REGEX_NOT_WORD_BOUNDARY = " << static_cast<int>(RegexAutomaton::NOT_WORD_BOUNDARY) << ";\n\n"
+       << "struct RegexState {\n"
+       << "    uint8_t type;\n"
+       << "    uint32_t next;\n"
+       << "    uint32_t argument;\n"
+       << "};\n\n"
+       << "constexpr bool isRegexWordCharacter(char c) {\n"
+       << "    return ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_');\n"
+       << "}\n\n"
+       << "/// @brief The regex locations of a server, compiled into one automaton that is matched in a single pass over the URL.\n"
+       << "template <size_t StateCount, size_t ClassCount, size_t PatternCount>\n"
+       << "struct RegexAutomaton {\n"
+       << "    std::array<RegexState, StateCount> states;\n"
+       << "    std::array<std::array<uint64_t, 4>, ClassCount> classes;\n"
+       << "    std::array<uint32_t, PatternCount> starts;\n\n"
+       << "    /// @brief Find the first pattern that matches anywhere in the input.\n"
+       << "    /// @return The index of the pattern, or PatternCount if none matches.\n"
+       << "    constexpr size_t firstMatch(std::string_view input) const {\n"
+       << "        std::vector<uint32_t> current, next, stack;\n"
+       << "        std::vector<size_t> marks(StateCount, 0);\n"
+       << "        size_t matched = PatternCount;\n\n"
+       << "        for (size_t position = 0; ; ++position) {\n"
+       << "            for (uint32_t start : starts)\n"
+       << "                addThread(current, stack, marks, start, position, input, matched);\n"
+       << "            if (matched == 0 || position == input.size())\n"
+       << "                return (matched);\n\n"
+       << "            unsigned char c = static_cast<unsigned char>(input[position]);\n"
+       << "            next.clear();\n"
+       << "            for (uint32_t state : current)\n"
+       << "                if ((classes[states[state].argument][c >> 6] >> (c & 63)) & 1)\n"
+       << "                    addThread(next, stack, marks, states[state].next, position + 1, input, matched);\n"
+       << "            current.swap(next);\n"
+       << "        }\n"
+       << "    }\n\n"
+       << "    /// @brief Add a state and everything reachable from it without consuming a character (marks hold position + 1).\n"
+       << "    constexpr void addThread(std::vector<uint32_t> &list, std::vector<uint32_t> &stack, std::vector<size_t> &marks,\n"
+       << "        uint32_t state, size_t position, std::string_view input, size_t &matched) const {\n"
+       << "        bool before = position > 0 && isRegexWordCharacter(input[position - 1]);\n"
+       << "        bool after = position < input.size() && isRegexWordCharacter(input[position]);\n\n"
+       << "        stack.push_back(state);\n"
+       << "        while (!stack.empty()) {\n"
+       << "            uint32_t current = stack.back();\n"
+       << "            stack.pop_back();\n"
+       << "            if (marks[current] == position + 1)\n"
+       << "                continue;\n"
+       << "            marks[current] = position + 1;\n\n"
+       << "            const RegexState &s = states[current];\n"
+       << "            bool follow = (s.type == REGEX_ASSERT_BEGIN && position == 0) || (s.type == REGEX_ASSERT_END && position == input.size())\n"
+       << "                || (s.type == REGEX_WORD_BOUNDARY && before != after) || (s.type == REGEX_NOT_WORD_BOUNDARY && before == after);\n"
+       << "            if (s.type == REGEX_CHAR_CLASS)\n"
+       << "                list.push_back(current);\n"
+       << "            else if (s.type == REGEX_MATCH)\n"
+       << "                matched = (s.argument < matched) ? s.argument : matched;\n"
+       << "            else if (s.type == REGEX_SPLIT) {\n"
+       << "                stack.push_back(s.argument);\n"
+       << "                stack.push_back(s.next);\n"
+       << "            } else if (follow)\n"
+       << "                stack.push_back(s.next);\n"
+       << "        }\n"
+       << "    }\n"
+       << "};\n\n";
+}
+
+/// @brief Emit the automaton of the regex locations of a server.
+/// @return The name of the automaton.
+static std::string emitRegexAutomaton(std::ostream &os, const RegexAutomaton &automaton, const std::vector<size_t> &regexLocations,
+    const std::string &prefix) {
+    const std::vector<RegexAutomaton::State> &states = automaton.getStates();
+    const std::vector<RegexAutomaton::CharClass> &classes = automaton.getClasses();
+    const std::vector<uint32_t> &starts = automaton.getStarts();
+    std::string name = prefix + "Regex";
+
+    os << "inline constexpr RegexAutomaton<" << states.size() << ", " << classes.size() << ", " << starts.size() << "> "
+       << name << " = {\n    {{";
+    for (size_t i = 0; i < states.size(); ++i)
+        os << (i % 8 == 0 ? "\n        " : " ") << "{" << static_cast<int>(states[i].type) << ", " << states[i].next << ", "
+           << states[i].argument << "},";
+    os << "\n    }},\n    {{";
+    for (const RegexAutomaton::CharClass &charClass : classes)
+        os << "\n        {" << charClass[0] << "u, " << charClass[1] << "u, " << charClass[2] << "u, " << charClass[3] << "u},";
+    os << "\n    }},\n    {{";
+    for (size_t i = 0; i < starts.size(); ++i)
+        os << (i ? ", " : "") << starts[i];
+    os << "}},\n};\n\n"
+       << "inline constexpr std::array<size_t, " << regexLocations.size() << "> " << name << "Locations = {";
+    for (size_t i = 0; i < regexLocations.size(); ++i)
+        os << (i ? ", " : "") << regexLocations[i];
+    os << "};\n\n";
+    return (name);
+}
+
+static void emitPreamble(std::ostream &os, const std::string &sourcePath, bool needsRegex) {
+    os << "// Generated from " << sourcePath << " by `parser --emit-cpp` - do not edit.\n"
+       << "#pragma once\n\n"
+       << "#include <string_view>\n"
+       << "#include <cstdint>\n"
+       << "#include <cstddef>\n"
+       << "#include <array>\n";
+    if (needsRegex)
+        os << "#include <vector>\n";
+
+    os << "\nnamespace generated_config {\n\n"
+       << "inline constexpr uint32_t METHOD_GET = " << static_cast<uint32_t>(GET) << ";\n"
+       << "inline constexpr uint32_t METHOD_POST = " << static_cast<uint32_t>(POST) << ";\n"
+       << "inline constexpr uint32_t METHOD_DELETE = " << static_cast<uint32_t>(DELETE) << ";\n"
+       << "inline constexpr uint32_t METHOD_PUT = " << static_cast<uint32_t>(PUT) << ";\n"
+       << "inline constexpr uint32_t METHOD_HEAD = " << static_cast<uint32_t>(HEAD) << ";\n"
+       << "inline constexpr uint32_t METHOD_OPTIONS = " << static_cast<uint32_t>(OPTIONS) << ";\n\n"
+       << "inline constexpr uint8_t MATCH_PREFIX = " << static_cast<int>(PREFIX_MATCH) << ";\n"
+       << "inline constexpr uint8_t MATCH_EXACT = " << static_cast<int>(EXACT_MATCH) << ";\n"
+       << "inline constexpr uint8_t MATCH_REGEX = " << static_cast<int>(REGEX_MATCH) << ";\n\n"
+       << "inline constexpr int ERROR_PAGE_FIRST_CODE = " << ERROR_PAGE_TABLE_FIRST_CODE << ";\n"
+       << "inline constexpr size_t ERROR_PAGE_COUNT = " << ERROR_PAGE_TABLE_SIZE << ";\n\n"
+       << "/// The error page of every status code, indexed by (status code - ERROR_PAGE_FIRST_CODE), with the wildcard page folded in.\n"
+       << "using ErrorPageTable = std::array<std::string_view, ERROR_PAGE_COUNT>;\n\n"
+       << "struct CgiExtension {\n"
+       << "    std::string_view extension;\n"
+       << "    std::string_view interpreter;\n"
+       << "};\n\n"
+       << "struct Location {\n"
+       << "    std::string_view path;\n"
+       << "    uint8_t modifier;\n"
+       << "    uint32_t methods;\n"
+       << "    std::string_view root;\n"
+       << "    std::string_view mappedRoot;\n"
+       << "    size_t urlPrefixLength;\n"
+       << "    std::string_view uploadDir;\n"
+       << "    bool autoIndex;\n"
+       << "    const std::string_view *indexFiles;\n"
+       << "    size_t indexFileCount;\n"
+       << "    int returnCode;\n"
+       << "    std::string_view returnParameter;\n"
+       << "    const ErrorPageTable *errorPages;\n"
+       << "    bool errorPageCache;\n"
+       << "    size_t maxBodySize;\n"
+       << "    bool cgi;\n"
+       << "    double cgiTimeout;\n"
+       << "    const CgiExtension *cgiExtensions;\n"
+       << "    size_t cgiExtensionCount;\n"
+       << "};\n\n"
+       << "struct Server {\n"
+       << "    uint16_t port;\n"
+       << "    bool defaultServer;\n"
+       << "    std::string_view serverName;\n"
+       << "    const Location *locations;\n"
+       << "    size_t locationCount;\n"
+       << "    const Location *defaultLocation;\n"
+       << "    /// Route a normalized path (without query string, percent-encoding and dot-segments, see Path::normalizeUrl).\n"
+       << "    const Location &(*route)(std::string_view uri);\n"
+       << "};\n\n"
+       << "/// @brief Get the error page of a status code, or an empty view if the location has none.\n"
+       << "constexpr std::string_view getErrorPage(const Location &location, int code) {\n"
+       << "    if (!location.errorPages || code < ERROR_PAGE_FIRST_CODE || code >= ERROR_PAGE_FIRST_CODE + static_cast<int>(ERROR_PAGE_COUNT))\n"
+       << "        return {};\n"
+       << "    return ((*location.errorPages)[code - ERROR_PAGE_FIRST_CODE]);\n"
+       << "}\n\n";
+    if (needsRegex)
+        emitRegexMatcher(os);
+}
+
+/// @brief Emit the error page table of a location, or reuse the table of an earlier location with the same pages.
+/// @return The name of the table, or an empty string if the location has no error pages.
+static std::string emitErrorPages(std::ostream &os, const ErrorPageRule &errorPages, ErrorPageTables &tables) {
+    std::vector<std::pair<int, std::string>> pages;
+    for (const auto &[code, page] : errorPages.getErrorPages())
+        pages.emplace_back(code.value, page.str());
+    if (pages.empty())
+        return ("");
+
+    auto it = tables.find(pages);
+    if (it != tables.end())
+        return (it->second);
+
+    std::string name = "errorPages" + std::to_string(tables.size());
+    tables.emplace(pages, name);
+
+    os << "inline constexpr ErrorPageTable " << name << " = {{";
+    for (int i = 0; i < ERROR_PAGE_TABLE_SIZE; ++i) {
+        std::string_view page = errorPages.getErrorPage(StatusCode(ERROR_PAGE_TABLE_FIRST_CODE + i));
+        os << (i % 10 == 0 ? "\n    " : " ") << (page.empty() ? "{}" : cppString(page)) << ",";
+    }
+    os << "\n}};\n\n";
+    return (name);
+}
+
+static LocationTables emitLocationTables(std::ostream &os, const LocationRule &location, const std::string &prefix,
+    ErrorPageTables &errorPageTables) {
+    const LocationColdRules &cold = location.cold();
+    LocationTables tables;
+
+    const std::vector<InternedString> &indexFiles = cold.index.getIndexFiles();
+    if (!indexFiles.empty()) {
+        tables.indexFiles = prefix + "IndexFiles";
+        os << "inline constexpr std::array<std::string_view, " << indexFiles.size() << "> " << tables.indexFiles << " = {";
+        for (size_t i = 0; i < indexFiles.size(); ++i)
+            os << (i ? ", " : "") << cppString(indexFiles[i].str());
+        os << "};\n";
+    }
+
+    const std::vector<CgiExtension> &extensions = cold.cgiExtention.getExtensions();
+    if (!extensions.empty()) {
+        tables.cgiExtensions = prefix + "CgiExtensions";
+        os << "inline constexpr std::array<CgiExtension, " << extensions.size() << "> " << tables.cgiExtensions << " = {{";
+        for (size_t i = 0; i < extensions.size(); ++i)
+            os << (i ? ", " : "") << "{" << cppString(extensions[i].extension.str()) << ", " << cppString(extensions[i].interpreter.str()) << "}";
+        os << "}};\n";
+    }
+
+    tables.errorPages = emitErrorPages(os, cold.errorPages, errorPageTables);
+    return (tables);
+}
+
+static void emitLocation(std::ostream &os, const LocationRule &location, const LocationTables &tables, const std::string &indent) {
+    const LocationColdRules &cold = location.cold();
+
+    os << indent << "Location{\n"
+       << indent << "    .path = " << cppString(location.path.str()) << ",\n"
+       << indent << "    .modifier = " << static_cast<int>(location.modifier) << ",\n"
+       << indent << "    .methods = " << static_cast<uint32_t>(location.methods.getMethods()) << ",\n"
+       << indent << "    .root = " << cppString(location.root.getRootPath().str()) << ",\n"
+       << indent << "    .mappedRoot = " << cppString(location.getMappedRoot()) << ",\n"
+       << indent << "    .urlPrefixLength = " << location.getUrlPrefixLength() << ",\n"
+       << indent << "    .uploadDir = " << (cold.uploadStore.isSet() ? cppString(cold.uploadStore.getUploadDir().str()) : "{}") << ",\n"
+       << indent << "    .autoIndex = " << (cold.autoIndex.get() ? "true" : "false") << ",\n"
+       << indent << "    .indexFiles = " << (tables.indexFiles.empty() ? "nullptr" : tables.indexFiles + ".data()") << ",\n"
+       << indent << "    .indexFileCount = " << cold.index.getIndexFiles().size() << ",\n"
+       << indent << "    .returnCode = " << (location.returnRule.isSet() ? location.returnRule.getStatusCode().value : 0) << ",\n"
+       << indent << "    .returnParameter = " << (location.returnRule.isSet() ? cppString(location.returnRule.getParameter()) : "{}") << ",\n"
+       << indent << "    .errorPages = " << (tables.errorPages.empty() ? "nullptr" : "&" + tables.errorPages) << ",\n"
+       << indent << "    .errorPageCache = " << (cold.errorPageCache.isEnabled() ? "true" : "false") << ",\n"
+       << indent << "    .maxBodySize = " << cold.maxBodySize.getMaxBodySize().get() << "u,\n"
+       << indent << "    .cgi = " << (location.cgi.isEnabled() ? "true" : "false") << ",\n"
+       << indent << "    .cgiTimeout = " << cppDouble(cold.cgiTimeout.timeout.getSeconds()) << ",\n"
+       << indent << "    .cgiExtensions = " << (tables.cgiExtensions.empty() ? "nullptr" : tables.cgiExtensions + ".data()") << ",\n"
+       << indent << "    .cgiExtensionCount = " << cold.cgiExtention.getExtensions().size() << ",\n"
+       << indent << "}";
+}
+
+/// @brief Emit the matching of one level of the prefix tree: a switch on the character at an offset, where every case
+/// compares the rest of its run of characters at once and records the location that ends there before descending.
+static void emitPrefixNode(std::ostream &os, const PrefixNode &node, size_t offset, const std::string &indent) {
+    if (node.children.empty())
+        return ;
+
+    os << indent << "switch (uri.size() > " << offset << " ? uri[" << offset << "] : '\\0') {\n";
+    for (const auto &[c, child] : node.children) {
+        std::string run;
+        const PrefixNode *end = child.get();
+        while (end->location < 0 && end->children.size() == 1) {
+            run.push_back(end->children.begin()->first);
+            end = end->children.begin()->second.get();
+        }
+
+        os << indent << "    case " << cppChar(c) << ":\n";
+        std::string bodyIndent = indent + "        ";
+        if (!run.empty()) {
+            os << bodyIndent << "if (uri.substr(" << offset + 1 << ").starts_with(" << cppString(run) << ")) {\n";
+            bodyIndent += "    ";
+        }
+        if (end->location >= 0)
+            os << bodyIndent << "best = " << end->location << ";\n";
+        emitPrefixNode(os, *end, offset + 1 + run.size(), bodyIndent);
+        if (!run.empty())
+            os << indent << "        }\n";
+        os << indent << "        break;\n";
+    }
+    os << indent << "}\n";
+}
+
+/// @brief Emit the routing function of a server, with the same lookup order as ServerConfig::getRoute():
+/// exact locations, then the regex locations and finally the longest matching prefix location.
+static void emitRouter(std::ostream &os, const ServerConfig &server, const std::string &prefix) {
+    const std::vector<LocationRule> &locations = server.getLocations();
+    RegexAutomaton automaton;
+    std::vector<size_t> regexLocations;
+    std::string error;
+    PrefixNode root;
+
+    for (size_t i = 0; i < locations.size(); ++i) {
+        const std::string &path = locations[i].path.str();
+        if (locations[i].modifier == LocationModifier::REGEX_MATCH) {
+            if (automaton.add(path, error))
+                regexLocations.push_back(i);
+        } else if (locations[i].modifier == LocationModifier::PREFIX_MATCH) {
+            PrefixNode *node = &root;
+            for (char c : path) {
+                std::unique_ptr<PrefixNode> &child = node->children[c];
+                if (!child)
+                    child = std::make_unique<PrefixNode>();
+                node = child.get();
+            }
+            if (node->location < 0)
+                node->location = static_cast<long>(i);
+        }
+    }
+
+    std::string regexName;
+    if (!regexLocations.empty())
+        regexName = emitRegexAutomaton(os, automaton, regexLocations, prefix);
+
+    os << "constexpr const Location &" << prefix << "Route(std::string_view uri) {\n";
+
+    std::set<std::string_view> exactPaths;
+    for (size_t i = 0; i < locations.size(); ++i)
+        if (locations[i].modifier == LocationModifier::EXACT_MATCH && exactPaths.insert(locations[i].path.str()).second)
+            os << "    if (uri == " << cppString(locations[i].path.str()) << ") return (" << prefix << "Locations[" << i << "]);\n";
+    if (!exactPaths.empty())
+        os << "\n";
+
+    if (!regexName.empty())
+        os << "    if (size_t regex = " << regexName << ".firstMatch(uri); regex < " << regexName << "Locations.size())\n"
+           << "        return (" << prefix << "Locations[" << regexName << "Locations[regex]]);\n\n";
+
+    if (root.children.empty() && exactPaths.empty() && regexName.empty())
+        os << "    static_cast<void>(uri);\n";
+    os << "    long best = -1;\n";
+    emitPrefixNode(os, root, 0, "    ");
+    os << "    return (best < 0 ? " << prefix << "DefaultLocation : " << prefix << "Locations[static_cast<size_t>(best)]);\n"
+       << "}\n\n";
+}
+
+void emitCpp(std::ostream &os, const std::vector<ServerConfig> &servers, const std::string &sourcePath) {
+    ErrorPageTables errorPageTables;
+    bool needsRegex = false;
+
+    for (const ServerConfig &server : servers)
+        for (const LocationRule &location : server.getLocations())
+            needsRegex |= (location.modifier == LocationModifier::REGEX_MATCH);
+    emitPreamble(os, sourcePath, needsRegex);
+
+    for (size_t s = 0; s < servers.size(); ++s) {
+        const ServerConfig &server = servers[s];
+        const std::vector<LocationRule> &locations = server.getLocations();
+        std::string prefix = "server" + std::to_string(s);
+
+        os << "// server " << s << ": " << server.serverName.getServerName() << ":" << server.port.getPort().value << "\n\n";
+        std::vector<LocationTables> tables;
+        for (size_t i = 0; i < locations.size(); ++i)
+            tables.push_back(emitLocationTables(os, locations[i], prefix + "Location" + std::to_string(i), errorPageTables));
+        LocationTables defaultTables = emitLocationTables(os, server.getDefaultLocation(), prefix + "DefaultLocation", errorPageTables);
+
+        os << "\ninline constexpr std::array<Location, " << locations.size() << "> " << prefix << "Locations = {{\n";
+        for (size_t i = 0; i < locations.size(); ++i) {
+            emitLocation(os, locations[i], tables[i], "    ");
+            os << ",\n";
+        }
+        os << "}};\n\n"
+           << "inline constexpr Location " << prefix << "DefaultLocation = ";
+        emitLocation(os, server.getDefaultLocation(), defaultTables, "");
+        os << ";\n\n";
+
+        emitRouter(os, server, prefix);
+    }
+
+    os << "inline constexpr std::array<Server, " << servers.size() << "> servers = {{\n";
+    for (size_t s = 0; s < servers.size(); ++s) {
+        std::string prefix = "server" + std::to_string(s);
+        os << "    Server{" << servers[s].port.getPort().value << ", " << (servers[s].port.isDefault() ? "true" : "false") << ", "
+           << cppString(servers[s].serverName.getServerName()) << ", " << prefix << "Locations.data(), " << prefix << "Locations.size(), &"
+           << prefix << "DefaultLocation, &" << prefix << "Route},\n";
+    }
+    os << "}};\n\n"
+       << "}\n";
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+class ServerConfig;
+
+/// @brief Generates a C++ header that contains a resolved configuration as constexpr tables, so a server with a fixed
+/// configuration can compile it in instead of parsing it at startup.
+/// The header has one table per server with its locations, the error pages as lookup arrays indexed by status code
+/// (shared between locations with the same pages), and one routing function per server: exact locations are compared
+/// directly and prefix locations are matched by a generated radix tree of switch statements, which always finds the
+/// longest prefix. Regex locations are matched by the same automaton as ServerConfig, emitted as tables - so every
+/// routing function is constexpr.
+/// @note The generated code only needs the standard library, not this parser.
+void emitCpp(std::ostream &os, const std::vector<ServerConfig> &servers, const std::string &sourcePath);
@@ -0,0 +1,45 @@
+#include "diagnostics.hpp"
+
+/// @brief Get the sink of the file a token comes from.
+/// @return The sink, or nullptr if errors in the file are thrown.
+DiagnosticSink *DiagnosticSink::of(const Token *token) {
+    if (!token || !token->configFile)
+        return (nullptr);
+    return (token->configFile->diagnostics);
+}
+
+/// @brief Get the number of errors reported to a sink - parsers compare it with the count they started with to detect a failure.
+size_t DiagnosticSink::countOf(const DiagnosticSink *sink) {
+    return (sink ? sink->size() : 0);
+}
+
+/// @brief Add the inclusion chain of a rule to the errors reported since a given index.
+/// This is the equivalent of catching the exceptions of an included file and adding the include rule before re-throwing them.
+/// @param first The number of errors before the include was handled.
+/// @param rule The include rule.
+void DiagnosticSink::addTracebackFromRule(size_t first, Rule *rule) {
+    for (size_t i = first; i < _diagnostics.size(); ++i)
+        _diagnostics[i]->addTracebackFromRule(rule);
+}
+
+/// @brief Print every reported error, in the order they were found.
+void DiagnosticSink::print(std::ostream &os) const {
+    for (const std::unique_ptr<ParserException> &diagnostic : _diagnostics)
+        os << diagnostic->getMessage();
+}
+
+void DiagnosticSink::clear() {
+    _diagnostics.clear();
+}
+
+bool DiagnosticSink::empty() const {
+    return (_diagnostics.empty());
+}
+
+size_t DiagnosticSink::size() const {
+    return (_diagnostics.size());
+}
+
+const std::vector<std::unique_ptr<ParserException>> &DiagnosticSink::getDiagnostics() const {
+    return (_diagnostics);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "parserExceptions.hpp"
+#include "config.hpp"
+
+#include <ostream>
+#include <memory>
+#include <vector>
+
+/// @brief Collects the errors of a parse instead of throwing them, so an invalid configuration is as cheap to validate as a valid one.
+/// Errors are reported to the sink of the file they are found in; a file without a sink throws them as before.
+/// After reporting, the lexer returns an END token, the parser returns nullptr, the converters return a default value
+/// and every following call on the same RuleParser or ObjectParser does nothing - so a mistake is only reported once.
+/// @note The diagnostics point into the arena of the parser, so they have to be printed before the parser is destroyed.
+class DiagnosticSink {
+private:
+    std::vector<std::unique_ptr<ParserException>> _diagnostics;
+
+public:
+    DiagnosticSink() = default;
+    DiagnosticSink(const DiagnosticSink&) = delete;
+    DiagnosticSink& operator=(const DiagnosticSink&) = delete;
+    ~DiagnosticSink() = default;
+
+    /// @brief Report an error to a sink, or throw it when there is no sink.
+    /// @tparam E The exception type of the error.
+    /// @param sink The sink to report to, or nullptr to throw.
+    /// @param args The arguments to construct the exception with.
+    template <typename E, typename... Args>
+    static void report(DiagnosticSink *sink, Args&&... args) {
+        if (!sink)
+            throw E(std::forward<Args>(args)...);
+        sink->_diagnostics.push_back(std::make_unique<E>(std::forward<Args>(args)...));
+    }
+
+    static DiagnosticSink *of(const Token *token);
+    static size_t countOf(const DiagnosticSink *sink);
+
+    void addTracebackFromRule(size_t first, Rule *rule);
+    void print(std::ostream &os) const;
+    void clear();
+
+    bool empty() const;
+    size_t size() const;
+    const std::vector<std::unique_ptr<ParserException>> &getDiagnostics() const;
+};
@@ -0,0 +1,218 @@
+#include "jsonWriter.hpp"
+
+#include <array>
+#include <cmath>
+
+/// @brief The bytes that cannot be copied as they are: the control characters, the quote and the backslash, which have
+/// to be escaped, and the bytes of non-ASCII characters, which have to be validated.
+static constexpr std::array<bool, 256> needsEscape = [] {
+    std::array<bool, 256> table{};
+
+    for (size_t c = 0; c < 0x20; ++c)
+        table[c] = true;
+    for (size_t c = 0x80; c < 0x100; ++c)
+        table[c] = true;
+    table['"'] = true;
+    table['\\'] = true;
+    return (table);
+}();
+
+/// @brief Get the length of the well-formed UTF-8 sequence at the start of a string (see the Unicode standard, table 3-7).
+/// @return The length of the sequence, or 0 if it is an overlong form, a surrogate, above U+10FFFF or truncated.
+static size_t utf8SequenceLength(std::string_view str) {
+    unsigned char lead = static_cast<unsigned char>(str[0]);
+    unsigned char secondMin = 0x80;
+    unsigned char secondMax = 0xbf;
+    size_t length;
+
+    if (lead >= 0xc2 && lead <= 0xdf)
+        length = 2;
+    else if (lead >= 0xe0 && lead <= 0xef)
+        length = 3;
+    else if (lead >= 0xf0 && lead <= 0xf4)
+        length = 4;
+    else
+        return (0);
+
+    if (lead == 0xe0)
+        secondMin = 0xa0;
+    else if (lead == 0xed)
+        secondMax = 0x9f;
+    else if (lead == 0xf0)
+        secondMin = 0x90;
+    else if (lead == 0xf4)
+        secondMax = 0x8f;
+
+    if (str.size() < length)
+        return (0);
+    unsigned char second = static_cast<unsigned char>(str[1]);
+    if (second < secondMin || second > secondMax)
+        return (0);
+    for (size_t i = 2; i < length; ++i) {
+        if ((static_cast<unsigned char>(str[i]) & 0xc0) != 0x80)
+            return (0);
+    }
+    return (length);
+}
+
+JsonWriter::JsonWriter(size_t capacity) {
+    _buffer.reserve(capacity);
+    _hasValue.reserve(16);
+}
+
+/// @brief Escape a string for a JSON string literal, without the quotes.
+std::string JsonWriter::escape(std::string_view str) {
+    JsonWriter json(str.size() + 2);
+
+    json._appendEscaped(str);
+    return (std::move(json._buffer));
+}
+
+/// @brief Write the separator before a value: nothing after a key or at the start of a container, a comma otherwise.
+void JsonWriter::_separate() {
+    if (_afterKey) {
+        _afterKey = false;
+        return ;
+    }
+    if (_hasValue.empty())
+        return ;
+    if (_hasValue.back())
+        _buffer.push_back(',');
+    _hasValue.back() = true;
+}
+
+/// @brief Append a string with the JSON escapes applied. Runs of characters that need no escaping are copied at once.
+/// Every byte that is not part of a well-formed UTF-8 sequence is replaced by U+FFFD, so the output is always valid JSON.
+void JsonWriter::_appendEscaped(std::string_view str) {
+    static const char hexDigits[] = "0123456789abcdef";
+    size_t runStart = 0;
+
+    for (size_t i = 0; i < str.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(str[i]);
+        if (!needsEscape[c])
+            continue;
+        if (c >= 0x80) {
+            size_t length = utf8SequenceLength(str.substr(i));
+            if (length) {
+                i += length - 1;
+                continue;
+            }
+        }
+
+        _buffer.append(str.data() + runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+            case '"': _buffer.append("\\\""); break;
+            case '\\': _buffer.append("\\\\"); break;
+            case '\n': _buffer.append("\\n"); break;
+            case '\t': _buffer.append("\\t"); break;
+            case '\r': _buffer.append("\\r"); break;
+            default:
+                if (c >= 0x80) {
+                    _buffer.append("\\ufffd");
+                    break;
+                }
+                _buffer.append("\\u00");
+                _buffer.push_back(hexDigits[c >> 4]);
+                _buffer.push_back(hexDigits[c & 0xf]);
+        }
+    }
+    _buffer.append(str.data() + runStart, str.size() - runStart);
+}
+
+JsonWriter &JsonWriter::beginObject() {
+    _separate();
+    _buffer.push_back('{');
+    _hasValue.push_back(false);
+    return (*this);
+}
+
+JsonWriter &JsonWriter::endObject() {
+    _buffer.push_back('}');
+    _hasValue.pop_back();
+    return (*this);
+}
+
+JsonWriter &JsonWriter::beginArray() {
+    _separate();
+    _buffer.push_back('[');
+    _hasValue.push_back(false);
+    return (*this);
+}
+
+JsonWriter &JsonWriter::endArray() {
+    _buffer.push_back(']');
+    _hasValue.pop_back();
+    return (*this);
+}
+
+/// @brief Write the key of the next value in an object.
+JsonWriter &JsonWriter::key(std::string_view name) {
+    _separate();
+    _buffer.push_back('"');
+    _appendEscaped(name);
+    _buffer.append("\":");
+    _afterKey = true;
+    return (*this);
+}
+
+JsonWriter &JsonWriter::string(std::string_view value) {
+    _separate();
+    _buffer.push_back('"');
+    _appendEscaped(value);
+    _buffer.push_back('"');
+    return (*this);
+}
+
+/// @brief Write a floating point number in its shortest exact form. JSON has no infinity or NaN, so they are written as null.
+JsonWriter &JsonWriter::number(double value) {
+    if (!std::isfinite(value))
+        return (null());
+
+    char digits[32];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+
+    _separate();
+    _buffer.append(digits, result.ptr);
+    return (*this);
+}
+
+JsonWriter &JsonWriter::boolean(bool value) {
+    _separate();
+    _buffer.append(value ? "true" : "false");
+    return (*this);
+}
+
+JsonWriter &JsonWriter::null() {
+    _separate();
+    _buffer.append("null");
+    return (*this);
+}
+
+/// @brief End a top-level value with a newline, so several documents can be written as JSON lines.
+void JsonWriter::newline() {
+    _buffer.push_back('\n');
+}
+
+/// @brief Drop the written JSON but keep the capacity of the buffer, so the writer can be reused.
+void JsonWriter::clear() {
+    _buffer.clear();
+    _hasValue.clear();
+    _afterKey = false;
+}
+
+void JsonWriter::reserve(size_t capacity) {
+    _buffer.reserve(capacity);
+}
+
+const std::string &JsonWriter::str() const {
+    return (_buffer);
+}
+
+size_t JsonWriter::size() const {
+    return (_buffer.size());
+}
+
+std::ostream &operator<<(std::ostream &os, const JsonWriter &json) {
+    return (os.write(json.str().data(), json.str().size()));
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <type_traits>
+#include <string_view>
+#include <charconv>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#define JSON_WRITER_DEFAULT_CAPACITY (64 * 1024)
+
+/// @brief Writes compact JSON into a single growing buffer, so a document is built without temporary strings or stream formatting.
+/// Separators are inserted automatically: every value inside an object has to be preceded by key().
+/// @note The writer does not validate the structure - unbalanced begin/end calls produce invalid JSON.
+class JsonWriter {
+private:
+    std::string _buffer;
+    std::vector<bool> _hasValue;
+    bool _afterKey = false;
+
+    void _separate();
+    void _appendEscaped(std::string_view str);
+
+public:
+    explicit JsonWriter(size_t capacity = JSON_WRITER_DEFAULT_CAPACITY);
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+    ~JsonWriter() = default;
+
+    static std::string escape(std::string_view str);
+
+    JsonWriter &beginObject();
+    JsonWriter &endObject();
+    JsonWriter &beginArray();
+    JsonWriter &endArray();
+
+    JsonWriter &key(std::string_view name);
+    JsonWriter &string(std::string_view value);
+    JsonWriter &number(double value);
+
+    template <typename T> requires (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+    JsonWriter &number(T value) {
+        char digits[24];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+
+        _separate();
+        _buffer.append(digits, result.ptr);
+        return (*this);
+    }
+
+    JsonWriter &boolean(bool value);
+    JsonWriter &null();
+
+    void newline();
+    void clear();
+    void reserve(size_t capacity);
+
+    const std::string &str() const;
+    size_t size() const;
+};
+
+std::ostream &operator<<(std::ostream &os, const JsonWriter &json);
@@ -1,99 +1,185 @@
 #include "parserExceptions.hpp"
+#include "diagnostics.hpp"
 #include "../print.hpp"
 #include "config.hpp"
+#include "lexer.hpp"
 
 #include <ostream>
 #include <cstring>
 #include <string>
 
-static const TokenPattern tokenPatterns[] = {
-    {"{", 1, TokenType::OBJECT_OPEN},
-    {"}", 1, TokenType::OBJECT_CLOSE},
-    {";", 1, TokenType::RULE_END},
-    {"#", 1, TokenType::COMMENT},
-    {"'", 1, TokenType::QUOTE1},
-    {" ", 1, TokenType::WHITESPACE},
-    {"\"", 1, TokenType::QUOTE2},
-    {"\n", 1, TokenType::LINE_END},
-    {"\t", 1, TokenType::WHITESPACE},
-    {"\r", 1, TokenType::WHITESPACE},
-    {"\v", 1, TokenType::WHITESPACE},
-    {"\f", 1, TokenType::WHITESPACE},
-};
-
-Token *ConfigurationParser::getNextToken(ConfigFile *configFile, size_t &pos) {
-    for (const TokenPattern &pattern : tokenPatterns) {
-        if (configFile->fileContent.compare(pos, pattern.length, pattern.pattern) == 0) {
-            pos += pattern.length;
-            return (_arena.alloc<Token>(
-                pattern.type,
-                pattern.pattern,
-                configFile,
-                pos - pattern.length
-            ));
-        }
+/// @brief Create a lexer for a file that is loaded in memory (its fileContent and lineStarts are set).
+Lexer::Lexer(Arena &arena, ConfigFile *configFile)
+    : _arena(arena), _configFile(configFile), _stream(nullptr), _window(configFile->fileContent), _atLineStart(false) {}
+
+/// @brief Create a lexer that reads a file from a stream. The file's line starts and fingerprint are filled in while lexing.
+Lexer::Lexer(Arena &arena, ConfigFile *configFile, std::istream &stream)
+    : _arena(arena), _configFile(configFile), _stream(&stream), _buffer(LEXER_STREAM_BUFFER_SIZE) {}
+
+/// @brief Get the type of a single character.
+TokenType Lexer::_classify(int c) {
+    switch (c) {
+        case '{': return (TokenType::OBJECT_OPEN);
+        case '}': return (TokenType::OBJECT_CLOSE);
+        case ';': return (TokenType::RULE_END);
+        case '#': return (TokenType::COMMENT);
+        case '\'': return (TokenType::QUOTE1);
+        case '"': return (TokenType::QUOTE2);
+        case '\n': return (TokenType::LINE_END);
+        case ' ': case '\t': case '\r': case '\v': case '\f': return (TokenType::WHITESPACE);
+        case '\0': case -1: return (TokenType::END);
+        default: return (TokenType::WEAK_STR);
     }
+}
+
+/// @brief Slide the buffer to the next part of the stream.
+/// @return False if the end of the stream is reached (or there is no stream).
+bool Lexer::_refill() {
+    if (!_stream)
+        return (false);
+
+    _stream->read(_buffer.data(), _buffer.size());
+    size_t length = _stream->gcount();
+    if (length == 0)
+        return (false);
 
-    pos++;
-    return (_arena.alloc<Token>(
-        configFile->fileContent[pos] ? TokenType::WEAK_STR : TokenType::END,
-        std::string(1, configFile->fileContent[pos - 1]),
-        configFile,
-        pos - 1
-    ));
+    _windowOffset += _window.size();
+    _window = std::string_view(_buffer.data(), length);
+    _configFile->fingerprint.size += length;
+    _configFile->fingerprint.hash = FileFingerprint::hashContent(_window, _configFile->fingerprint.hash);
+    return (true);
 }
 
-Token *ConfigurationParser::parseContinuousToken(ConfigFile *configFile, size_t &pos, Token *currentToken, TokenType endOfStringTypeMask) {
-    while (true) {
-        Token *nextToken = getNextToken(configFile, pos);
-        if (nextToken->type & endOfStringTypeMask)
-            return (nextToken);
-        else
-            currentToken->value += nextToken->value;
+/// @brief Get the current character without consuming it, or -1 at the end of the input.
+int Lexer::_peekChar() {
+    if (_pos - _windowOffset >= _window.size() && !_refill())
+        return (-1);
+    return (static_cast<unsigned char>(_window[_pos - _windowOffset]));
+}
+
+/// @brief Consume the current character, recording where lines start when reading from a stream.
+void Lexer::_advance() {
+    if (_atLineStart) {
+        _configFile->lineStarts.push_back(_pos);
+        _atLineStart = false;
     }
+    if (_window[_pos - _windowOffset] == '\n')
+        _atLineStart = (_stream != nullptr);
+    ++_pos;
+}
+
+Token *Lexer::_token(TokenType type, std::string value, size_t filePos) {
+    size_t sourceLength = value.size();
+    return (_arena.alloc<Token>(type, std::move(value), _configFile, filePos, sourceLength));
+}
+
+/// @brief Report an error in the file (or throw it without a diagnostic sink) and stop lexing.
+/// @return The END token, which is returned for every following token as well.
+Token *Lexer::_fail(const std::string &message, Token *token, const std::string &hint) {
+    DiagnosticSink::report<ParserTokenException>(_configFile->diagnostics, message, token, hint);
+    _failed = true;
+    _end = _token(TokenType::END, "", _pos);
+    return (_end);
 }
 
-void ConfigurationParser::_tokenize(ConfigFile *configFile) {
-    size_t pos = 0;
+/// @brief Lex the next usable token - whitespace and comments are skipped.
+Token *Lexer::_lex() {
+    if (!_started) {
+        _started = true;
+        return (_token(TokenType::OBJECT_OPEN, "<sys>", 0));
+    }
+    if (_end)
+        return (_end);
 
-    Token *previousToken;
-    Token *currentToken = _arena.alloc<Token>(TokenType::OBJECT_OPEN, "<sys>", configFile, 0);
-    do {
-        previousToken = currentToken;
+    while (true) {
+        size_t start = _pos;
+        int c = _peekChar();
+        TokenType type = _classify(c);
 
-        switch (previousToken->type) {
+        switch (type) {
             case TokenType::END:
-                configFile->tokens.push_back(_arena.alloc<Token>(TokenType::OBJECT_CLOSE, "<sys>", configFile, pos));
-                break ;
+                // The synthetic object of the file is closed first, then the END token follows.
+                _end = _token(TokenType::END, "", start);
+                return (_token(TokenType::OBJECT_CLOSE, "<sys>", start));
 
-            case TokenType::WEAK_STR:
-                currentToken = parseContinuousToken(configFile, pos, previousToken, EOS_MASK_DEFAULT);
+            case TokenType::WHITESPACE:
+            case TokenType::LINE_END:
+                _advance();
                 break ;
 
             case TokenType::COMMENT:
-                previousToken->value.clear();
-                currentToken = parseContinuousToken(configFile, pos, previousToken, COMMENT_MASK);
+                while (!(_classify(_peekChar()) & COMMENT_MASK))
+                    _advance();
                 break ;
 
+            case TokenType::WEAK_STR: {
+                Token *token = _token(TokenType::WEAK_STR, "", start);
+                while (_classify(c) == TokenType::WEAK_STR) {
+                    token->value.push_back(static_cast<char>(c));
+                    _advance();
+                    c = _peekChar();
+                    // A variable reference ${name} is part of the string - its braces do not open or close an object.
+                    if (c == '{' && token->value.back() == '$') {
+                        do {
+                            token->value.push_back(static_cast<char>(c));
+                            _advance();
+                            c = _peekChar();
+                        } while (_classify(c) == TokenType::WEAK_STR);
+                        if (c == '}') {
+                            token->value.push_back('}');
+                            _advance();
+                            c = _peekChar();
+                        }
+                    }
+                }
+                token->sourceLength = _pos - start;
+                return (token);
+            }
+
             case TokenType::QUOTE1:
-            case TokenType::QUOTE2:
-                currentToken = getNextToken(configFile, pos);
-                if (currentToken->type == previousToken->type)
-                    throw ParserTokenException("Quote without content in configuration file", previousToken, "Put some content in the quotes; or remove them if not needed!");
-                if (parseContinuousToken(configFile, pos, currentToken, EOS_MASK_QUOTE(previousToken->type))->type != previousToken->type)
-                    throw ParserTokenException("Unmatched quote in configuration file", previousToken, "Close it dummy!");
-                currentToken->type = TokenType::STR; // Promote to STR type
-                previousToken = currentToken;
-                [[fallthrough]];
+            case TokenType::QUOTE2: {
+                Token *quoteToken = _token(type, std::string(1, static_cast<char>(c)), start);
+                _advance();
+
+                c = _peekChar();
+                if (_classify(c) == type)
+                    return (_fail("Quote without content in configuration file", quoteToken, "Put some content in the quotes; or remove them if not needed!"));
+
+                Token *token = _token(TokenType::STR, "", _pos);
+                while (!(_classify(c) & EOS_MASK_QUOTE(type))) {
+                    token->value.push_back(static_cast<char>(c));
+                    _advance();
+                    c = _peekChar();
+                }
+                token->sourceLength = _pos - token->filePos;
+                if (_classify(c) != type)
+                    return (_fail("Unmatched quote in configuration file", quoteToken, "Close it dummy!"));
+                _advance();
+                return (token);
+            }
 
             default:
-                currentToken = getNextToken(configFile, pos);
+                _advance();
+                return (_token(type, std::string(1, static_cast<char>(c)), start));
         }
+    }
+}
 
-        if (IS_USABLE_TOKEN_TYPE(previousToken->type))
-            configFile->tokens.push_back(previousToken);
+Token *Lexer::peek() {
+    if (!_peeked)
+        _peeked = _lex();
+    return (_peeked);
+}
+
+Token *Lexer::next() {
+    Token *token = peek();
+    _peeked = nullptr;
+    return (token);
+}
 
-    } while (previousToken->type != TokenType::END);
+/// @brief Check if the lexer reported an error. The parser uses it to not report the END token that follows as a second error.
+bool Lexer::failed() const {
+    return (_failed);
 }
 
 std::ostream &operator<<(std::ostream &os, const Token &token) {
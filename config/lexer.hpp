@@ -0,0 +1,55 @@
+#pragma once
+
+#include "config.hpp"
+#include "arena.hpp"
+
+#include <string_view>
+#include <istream>
+#include <cstdint>
+#include <vector>
+
+#define LEXER_STREAM_BUFFER_SIZE (64 * 1024)
+
+/// @brief Produces the tokens of a file on demand, only lexing as far as the recursive-descent parser has read.
+/// Lexing and parsing happen in a single pass, so tokens are never collected up front.
+/// The input is either the content of the file in memory, or a stream that is read through a fixed-size
+/// sliding buffer - so a file never has to be in memory as a whole. For streams the lexer records the line starts
+/// and the fingerprint of the file, as these cannot be computed up front.
+/// @note The lexer wraps the file in a synthetic <sys> object and ends it with an END token. After an error
+/// was reported to the diagnostic sink of the file, only END tokens follow.
+class Lexer {
+private:
+    Arena &_arena;
+    ConfigFile *_configFile;
+    std::istream *_stream;
+    std::vector<char> _buffer;
+    std::string_view _window;
+    size_t _windowOffset = 0;
+    size_t _pos = 0;
+    bool _atLineStart = true;
+
+    Token *_peeked = nullptr;
+    Token *_end = nullptr;
+    bool _started = false;
+    bool _failed = false;
+
+    static TokenType _classify(int c);
+
+    bool _refill();
+    int _peekChar();
+    void _advance();
+    Token *_token(TokenType type, std::string value, size_t filePos);
+    Token *_fail(const std::string &message, Token *token, const std::string &hint);
+    Token *_lex();
+
+public:
+    Lexer(Arena &arena, ConfigFile *configFile);
+    Lexer(Arena &arena, ConfigFile *configFile, std::istream &stream);
+    Lexer(const Lexer&) = delete;
+    Lexer& operator=(const Lexer&) = delete;
+    ~Lexer() = default;
+
+    Token *peek();
+    Token *next();
+    bool failed() const;
+};
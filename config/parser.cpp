@@ -1,9 +1,12 @@
 #include "parserExceptions.hpp"
+#include "diagnostics.hpp"
 #include "rules/ruleParser.hpp"
 #include "rules/rules.hpp"
 #include "../print.hpp"
 #include "config.hpp"
+#include "lexer.hpp"
 
+#include <istream>
 #include <memory>
 
 static Key getRuleKeyFromToken(Token *token) {
@@ -14,6 +17,7 @@ static Key getRuleKeyFromToken(Token *token) {
         {ServerNameRule::getRuleName(), ServerNameRule::getKey()},
         {MaxBodySizeRule::getRuleName(), MaxBodySizeRule::getKey()},
         {ErrorPageRule::getRuleName(), ErrorPageRule::getKey()},
+        {ErrorPageCacheRule::getRuleName(), ErrorPageCacheRule::getKey()},
         {RootRule::getRuleName(), RootRule::getKey()},
         {IndexRule::getRuleName(), IndexRule::getKey()},
         {AutoIndexRule::getRuleName(), AutoIndexRule::getKey()},
@@ -25,11 +29,14 @@ static Key getRuleKeyFromToken(Token *token) {
         {CgiExtensionRule::getRuleName(), CgiExtensionRule::getKey()},
         {DefineRule::getRuleName(), DefineRule::getKey()},
         {IncludeRule::getRuleName(), IncludeRule::getKey()},
+        {SetRule::getRuleName(), SetRule::getKey()},
     };
 
     auto it = keyMap.find(token->value);
-    if (it == keyMap.end())
-        throw ParserTokenException("Unknown rule key \"" + token->value + "\"", token);
+    if (it == keyMap.end()) {
+        DiagnosticSink::report<ParserTokenException>(DiagnosticSink::of(token), "Unknown rule key \"" + token->value + "\"", token);
+        return (Key::NO_KEY);
+    }
     return (it->second);
 }
 
@@ -65,10 +72,38 @@ Object *Object::deepCopy(Arena &arena, Rule *newParentRule) const {
 }
 
 Argument *Argument::deepCopy(Arena &arena, Rule *newParentRule) const {
-    Argument *newArg = arena.alloc<Argument>(type, value, newParentRule, token);
-    if (type == ArgumentType::OBJECT)
-        newArg->value = std::get<Object*>(value)->deepCopy(arena, newParentRule);
-    return (newArg);
+    Object *newObject = object ? object->deepCopy(arena, newParentRule) : nullptr;
+
+    return (arena.alloc<Argument>(token, newObject, newParentRule));
+}
+
+/// @brief Get the type of the argument. Weak strings are only matched against the keywords on first access.
+ArgumentType Argument::getType() const {
+    if (type == ArgumentType::UNKNOWN_ARGUMENT) {
+        if (object)
+            type = ArgumentType::OBJECT;
+        else if (token->type == TokenType::WEAK_STR && (keyword = ::getKeyword(token->value)) != Keyword::NO_KEYWORD)
+            type = ArgumentType::KEYWORD;
+        else
+            type = ArgumentType::STRING;
+    }
+    return (type);
+}
+
+/// @brief Get the keyword of the argument, or NO_KEYWORD if it is not a keyword.
+Keyword Argument::getKeyword() const {
+    getType();
+    return (keyword);
+}
+
+/// @brief Get the raw text of the argument.
+const std::string &Argument::getString() const {
+    return (token->value);
+}
+
+/// @brief Get the object of the argument, or nullptr if it is not an object.
+Object *Argument::getObject() const {
+    return (object);
 }
 
 Rule *Rule::deepCopy(Arena &arena, Object *newParentObject) const {
@@ -81,16 +116,82 @@ Rule *Rule::deepCopy(Arena &arena, Object *newParentObject) const {
     return (newRule);
 }
 
-void ConfigurationParser::_handleDefineRule(Rule *rule) {
+/// @return False if the rule is invalid - the error is reported to the diagnostic sink.
+bool ConfigurationParser::_handleDefineRule(Rule *rule) {
+    size_t reportedErrors = DiagnosticSink::countOf(_diagnostics);
     DefineRule defineRule(rule);
+    if (DiagnosticSink::countOf(_diagnostics) != reportedErrors)
+        return (false);
 
-    if (_objects.find(defineRule.getName()) != _objects.end())
-        throw ParserArgumentException("Object with name '" + defineRule.getName() + "' already exists", rule->arguments[0],
+    if (_objects.find(defineRule.getName()) != _objects.end()) {
+        DiagnosticSink::report<ParserArgumentException>(_diagnostics, "Object with name '" + defineRule.getName() + "' already exists", rule->arguments[0],
                 "Give the object a different (unique) name to avoid conflicts.");
-    if (defineRule.getName() == rule->token->configFile->fileName)
-        throw ParserArgumentException("Object name cannot be the same as the configuration file name", rule->arguments[0],
+        return (false);
+    }
+    if (defineRule.getName() == rule->token->configFile->fileName) {
+        DiagnosticSink::report<ParserArgumentException>(_diagnostics, "Object name cannot be the same as the configuration file name", rule->arguments[0],
             "Choose a different name for the object to avoid conflicts with the configuration file name.");
+        return (false);
+    }
     _objects[defineRule.getName()] = defineRule.getObject();
+    return (true);
+}
+
+/// @return False if the rule is invalid - the error is reported to the diagnostic sink.
+bool ConfigurationParser::_handleSetRule(Rule *rule, Object *object) {
+    size_t reportedErrors = DiagnosticSink::countOf(_diagnostics);
+    SetRule setRule(rule);
+    if (DiagnosticSink::countOf(_diagnostics) != reportedErrors)
+        return (false);
+
+    object->variables.insert_or_assign(setRule.getName(), setRule.getValue());
+    return (true);
+}
+
+/// @brief Find a variable in an object or the objects it is nested in, from the innermost to the outermost.
+/// @return The value, or nullptr if the variable is not set.
+static const InternedString *findVariable(const Object *scope, std::string_view name) {
+    for (; scope; scope = scope->parentRule ? scope->parentRule->parentObject : nullptr) {
+        auto it = scope->variables.find(name);
+        if (it != scope->variables.end())
+            return (&it->second);
+    }
+    return (nullptr);
+}
+
+/// @brief Replace every ${name} in a string token by the value of the variable, in a single pass.
+/// The values were expanded when they were set, so they are copied as they are. The source length of the token is kept,
+/// so errors in the expanded value still point at the text in the file.
+/// @return False if a variable is not set or a reference is not closed - the error is reported to the diagnostic sink.
+bool ConfigurationParser::_expandVariables(Token *token, const Object *scope) {
+    const std::string &value = token->value;
+    std::string expanded;
+    size_t position = 0;
+
+    expanded.reserve(value.size());
+    for (size_t start; (start = value.find("${", position)) != std::string::npos; ) {
+        size_t end = value.find('}', start + 2);
+        if (end == std::string::npos) {
+            DiagnosticSink::report<ParserTokenException>(_diagnostics, "Unterminated variable reference", token,
+                "Close the variable reference with '}', e.g. ${name}.");
+            return (false);
+        }
+
+        std::string_view name = std::string_view(value).substr(start + 2, end - start - 2);
+        const InternedString *variable = findVariable(scope, name);
+        if (!variable) {
+            DiagnosticSink::report<ParserTokenException>(_diagnostics, "Unknown variable '" + std::string(name) + "'", token,
+                "Set the variable with 'set $" + std::string(name) + " <value>;' before it is used, in this block or an enclosing one.");
+            return (false);
+        }
+
+        expanded.append(value, position, start - position);
+        expanded.append(variable->str());
+        position = end + 1;
+    }
+    expanded.append(value, position);
+    token->value = std::move(expanded);
+    return (true);
 }
 
 void ConfigurationParser::_includeObjectIntoScope(Object *object, Object *includedObject, Rule *includeRuleRef) {
@@ -104,80 +205,133 @@ void ConfigurationParser::_includeObjectIntoScope(Object *object, Object *includ
             object->rules[key].push_back(newRule);
         }
     }
+    _objectIncludes[object].push_back(includedObject->objectOpenToken->configFile->fileName);
 }
 
-void ConfigurationParser::_handleIncludeRule(ConfigFile *file, size_t &pos, Rule *rule, Object *object) {
+/// @brief Include a file or a define. A glob pattern includes every file it matches, in sorted order - the files are
+/// read at the same time, but parsed and included one by one.
+/// @return False if the rule or an included file is invalid - the error is reported to the diagnostic sink.
+bool ConfigurationParser::_handleIncludeRule(Lexer &lexer, Rule *rule, Object *object) {
+    size_t reportedErrors = DiagnosticSink::countOf(_diagnostics);
     IncludeRule includeRule(rule);
+    if (DiagnosticSink::countOf(_diagnostics) != reportedErrors)
+        return (false);
+
+    if (!includeRule.isPattern())
+        return (_includeFile(lexer, rule, object, includeRule.getIncludePath()));
+
+    std::vector<std::string> filePaths;
+    bool expanded;
+    try { expanded = _expandIncludePattern(includeRule.getIncludePath(), filePaths); }
+    catch (ParserException &e) {
+        e.addTracebackFromRule(rule);
+        throw;
+    }
+    if (!expanded) {
+        _diagnostics->addTracebackFromRule(reportedErrors, rule);
+        return (false);
+    }
+    _prefetchFiles(filePaths);
+    for (const std::string &filePath : filePaths)
+        if (!_includeFile(lexer, rule, object, filePath))
+            return (false);
+    return (true);
+}
 
-    if (!isFileLoaded(includeRule.getIncludePath())) {
-        try { _loadConfigFile(includeRule.getIncludePath()); }
+/// @return False if the included file is invalid - the error is reported to the diagnostic sink.
+bool ConfigurationParser::_includeFile(Lexer &lexer, Rule *rule, Object *object, const std::string &includePath) {
+    size_t reportedErrors = DiagnosticSink::countOf(_diagnostics);
+
+    if (!isFileLoaded(includePath)) {
+        try { _loadConfigFile(includePath); }
         catch (ParserException &e) {
             e.addTracebackFromRule(rule);
             throw;
         }
+        if (DiagnosticSink::countOf(_diagnostics) != reportedErrors) {
+            _diagnostics->addTracebackFromRule(reportedErrors, rule);
+            return (false);
+        }
     }
 
-    auto it = _objects.find(includeRule.getIncludePath());
-    if (it == _objects.end())
-        throw ParserTokenException("Included object '" + includeRule.getIncludePath() + "' not found in the configuration", file->tokens[pos]);
+    auto it = _objects.find(includePath);
+    if (it == _objects.end()) {
+        DiagnosticSink::report<ParserTokenException>(_diagnostics, "Included object '" + includePath + "' not found in the configuration", lexer.peek());
+        return (false);
+    }
+    _includeGraph[rule->token->configFile->fileName].insert(it->second->objectOpenToken->configFile->fileName);
     _includeObjectIntoScope(object, it->second, rule);
+    return (true);
 }
 
-Rule *ConfigurationParser::_parseRule(ConfigFile *file, size_t &pos, Object *parentObject) {
-    if (file->tokens[pos]->type != TokenType::WEAK_STR)
-        throw ParserTokenException("Expected a rule key, but found something else", file->tokens[pos]);
+/// @return The rule, or nullptr if it is invalid - the error is reported to the diagnostic sink.
+Rule *ConfigurationParser::_parseRule(Lexer &lexer, Object *parentObject) {
+    if (lexer.peek()->type != TokenType::WEAK_STR) {
+        if (!lexer.failed())
+            DiagnosticSink::report<ParserTokenException>(_diagnostics, "Expected a rule key, but found something else", lexer.peek());
+        return (nullptr);
+    }
 
-    Token *ruleToken = file->tokens[pos++];
-    Rule *rule = _arena.alloc<Rule>(getRuleKeyFromToken(ruleToken), std::vector<Argument*>(), parentObject, std::vector<Rule *>(), ruleToken, false);
+    Token *ruleToken = lexer.next();
+    Key key = getRuleKeyFromToken(ruleToken);
+    if (key == Key::NO_KEY)
+        return (nullptr);
+    Rule *rule = _arena.alloc<Rule>(key, std::vector<Argument*>(), parentObject, std::vector<Rule *>(), ruleToken, false);
 
     while (true) {
-        if (file->tokens[pos]->type == TokenType::RULE_END) {
-            ++pos;
+        Token *token = lexer.peek();
+
+        if (token->type == TokenType::RULE_END) {
+            lexer.next();
             break;
         }
 
-        else if (file->tokens[pos]->type == TokenType::OBJECT_OPEN) {
-            rule->arguments.push_back(_arena.alloc<Argument>(ArgumentType::OBJECT, _parseObject(file, pos, rule), rule, file->tokens[pos]));
-            if (file->tokens[pos]->type == TokenType::RULE_END)
-                ++pos;
+        else if (token->type == TokenType::OBJECT_OPEN) {
+            Object *object = _parseObject(lexer, rule);
+            if (!object)
+                return (nullptr);
+            rule->arguments.push_back(_arena.alloc<Argument>(lexer.peek(), object, rule));
+            if (lexer.peek()->type == TokenType::RULE_END)
+                lexer.next();
             break;
         }
 
-        else if (file->tokens[pos]->type == TokenType::WEAK_STR || file->tokens[pos]->type == TokenType::STR) {
-            if (file->tokens[pos]->type == TokenType::WEAK_STR) {
-                Keyword keyword = getKeyword(file->tokens[pos]->value);
-                if (keyword != Keyword::NO_KEYWORD) {
-                    rule->arguments.push_back(_arena.alloc<Argument>(ArgumentType::KEYWORD, keyword, rule, file->tokens[pos]));
-                    ++pos;
-                    continue;
-                }
-            }
-            rule->arguments.push_back(_arena.alloc<Argument>(ArgumentType::STRING, file->tokens[pos]->value, rule, file->tokens[pos]));
-            ++pos;
+        else if (token->type == TokenType::WEAK_STR || token->type == TokenType::STR) {
+            if (token->value.find("${") != std::string::npos && !_expandVariables(token, parentObject))
+                return (nullptr);
+            rule->arguments.push_back(_arena.alloc<Argument>(token, nullptr, rule));
+            lexer.next();
         }
 
-        else if (file->tokens[pos]->type == TokenType::STR || file->tokens[pos]->type == TokenType::WEAK_STR) {
-            rule->arguments.push_back(_arena.alloc<Argument>(ArgumentType::STRING, file->tokens[pos]->value, rule, file->tokens[pos]));
-            ++pos;
+        else {
+            if (!lexer.failed())
+                DiagnosticSink::report<ParserTokenException>(_diagnostics, "Unexpected token type while parsing rule", token);
+            return (nullptr);
         }
-
-        else
-            throw ParserTokenException("Unexpected token type while parsing rule", file->tokens[pos]);
     }
 
     return (rule);
 }
 
-Object *ConfigurationParser::_parseObject(ConfigFile *file, size_t &pos, Rule *parentRule) {
-    Object *object = _arena.alloc<Object>(std::map<Key, Rules>(), parentRule, file->tokens[pos++], nullptr);
+/// @return The object, or nullptr if it is invalid - the error is reported to the diagnostic sink.
+Object *ConfigurationParser::_parseObject(Lexer &lexer, Rule *parentRule) {
+    Object *object = _arena.alloc<Object>(std::map<Key, Rules>(), parentRule, lexer.next(), nullptr);
 
-    while (file->tokens[pos]->type != TokenType::OBJECT_CLOSE) {
-        Rule *rule = _parseRule(file, pos, object);
-        if (rule->key == Key::DEFINE)
-            _handleDefineRule(rule);
-        else if (rule->key == Key::INCLUDE)
-            _handleIncludeRule(file, pos, rule, object);
-        else {
+    while (lexer.peek()->type != TokenType::OBJECT_CLOSE) {
+        Rule *rule = _parseRule(lexer, object);
+        if (!rule)
+            return (nullptr);
+
+        if (rule->key == Key::DEFINE) {
+            if (!_handleDefineRule(rule))
+                return (nullptr);
+        } else if (rule->key == Key::SET) {
+            if (!_handleSetRule(rule, object))
+                return (nullptr);
+        } else if (rule->key == Key::INCLUDE) {
+            if (!_handleIncludeRule(lexer, rule, object))
+                return (nullptr);
+        } else {
             auto it = object->rules.find(rule->key);
             if (it == object->rules.end())
                 object->rules[rule->key] = Rules();
@@ -185,12 +339,18 @@ Object *ConfigurationParser::_parseObject(ConfigFile *file, size_t &pos, Rule *p
         }
     }
 
-    object->objectCloseToken = file->tokens[pos++];
+    object->objectCloseToken = lexer.next();
     return (object);
 }
 
-Object *ConfigurationParser::_getObjectFromFile(ConfigFile *file) {
-    size_t pos = 0;
+/// @brief Parse a loaded file into an object, lexing it while it is parsed.
+/// @param stream The stream to read a streamed file from, or nullptr if the file content is in memory.
+Object *ConfigurationParser::_getObjectFromFile(ConfigFile *file, std::istream *stream) {
+    if (stream) {
+        Lexer lexer(_arena, file, *stream);
+        return (_parseObject(lexer, nullptr));
+    }
 
-    return (_parseObject(file, pos, nullptr));
+    Lexer lexer(_arena, file);
+    return (_parseObject(lexer, nullptr));
 }
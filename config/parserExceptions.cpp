@@ -2,8 +2,11 @@
 #include "../print.hpp"
 #include "config.hpp"
 
+#include <algorithm>
+#include <fstream>
 #include <sstream>
 #include <string>
+#include <utility>
 
 ErrorContext ConfigFile::getErrorContext(size_t pos) const {
     auto lineEndIt = std::lower_bound(lineStarts.begin(), lineStarts.end(), pos + 1);
@@ -12,22 +15,30 @@ ErrorContext ConfigFile::getErrorContext(size_t pos) const {
     size_t lineNumber = std::distance(lineStarts.begin(), lineEndIt);
     size_t columnNumber = pos - *lineStartIt;
 
+    // Streamed files are not kept in memory, so the line is read again from disk.
+    std::string line;
+    if (streamed) {
+        std::ifstream file(fileName, std::ios::binary);
+        if (lineStartIt != lineStarts.end() && file.seekg(*lineStartIt) && std::getline(file, line))
+            line.push_back('\n');
+    } else
+        line = fileContent.substr(*lineStartIt, (lineEndIt != lineStarts.end() ? *lineEndIt : fileContent.size()) - *lineStartIt);
+
     return (ErrorContext{
         .filename = fileName,
-        .line = fileContent.substr(*lineStartIt, (lineEndIt != lineStarts.end() ? *lineEndIt : fileContent.size()) - *lineStartIt),
+        .line = line,
         .lineNumber = lineNumber,
         .columnNumber = columnNumber
     });
 }
 
-static std::vector<ErrorContext> loadTraceback(const Rule *rule) {
-    std::vector<ErrorContext> traceback;
+/// @brief Collect the include rules through which a rule ended up in its object - from the innermost to the outermost.
+std::vector<const Rule*> ParserException::_collectIncludeRules(const Rule *rule) {
+    std::vector<const Rule*> traceback;
 
     const Rule *currentRule = rule;
     while (currentRule && currentRule->parentObject) {
-        for (auto it = currentRule->includeRuleRefs.begin(); it != currentRule->includeRuleRefs.end(); ++it)
-            traceback.push_back((*it)->token->configFile->getErrorContext((*it)->token->filePos));
-
+        traceback.insert(traceback.end(), currentRule->includeRuleRefs.begin(), currentRule->includeRuleRefs.end());
         currentRule = currentRule->parentObject->parentRule;
     }
 
@@ -37,26 +48,33 @@ static std::vector<ErrorContext> loadTraceback(const Rule *rule) {
 ParserException::ParserException(const std::string &message, const std::string &hint)
     : _message(message), _hint(hint), _traceback() {}
 
-ParserException::ParserException(const std::string &message, const std::string &hint, std::vector<ErrorContext> traceback)
+ParserException::ParserException(const std::string &message, const std::string &hint, std::vector<const Rule*> traceback)
     : _message(message), _hint(hint), _traceback(std::move(traceback)) {}
 
-void ParserException::_printErrorContext(const ErrorContext &context, const Token *token, std::ostream &oss) const {
-    size_t errorLength = token->value.length();
-    if (token->type & (TokenType::QUOTE1 | TokenType::QUOTE2))
+/// @brief Get the column and the length of the part of the line that a token covers, bounded by the line.
+/// The source length is used rather than the value, which differs from the text in the file once variables are expanded.
+static std::pair<size_t, size_t> tokenSpan(const ErrorContext &context, const Token *token) {
+    size_t errorLength = token->sourceLength;
+    if (token->type & (TokenType::QUOTE1 | TokenType::QUOTE2 | TokenType::END))
         errorLength = 1;
 
+    size_t column = std::min(context.columnNumber, context.line.size());
+    return {column, std::min(errorLength, context.line.size() - column)};
+}
+
+void ParserException::_printErrorContext(const ErrorContext &context, const Token *token, std::ostream &oss) const {
+    auto [column, errorLength] = tokenSpan(context, token);
+
     oss << "Error found in " << context.filename << " at line " << context.lineNumber << ":" << context.columnNumber + 1 << "\n";
-    oss << context.line.substr(0, context.columnNumber) << TERM_COLOR_RED << TERM_BOLD << context.line.substr(context.columnNumber, errorLength) << TERM_COLOR_RESET << context.line.substr(context.columnNumber + errorLength);
-    oss << std::string(context.columnNumber, ' ') << TERM_COLOR_CYAN << std::string(errorLength, '^') << TERM_COLOR_RESET << "\n";
+    oss << context.line.substr(0, column) << TERM_COLOR_RED << TERM_BOLD << context.line.substr(column, errorLength) << TERM_COLOR_RESET << context.line.substr(column + errorLength);
+    oss << std::string(column, ' ') << TERM_COLOR_CYAN << std::string(errorLength, '^') << TERM_COLOR_RESET << "\n";
 }
 
 void ParserException::_printCompactErrorContext(const ErrorContext &context, const Token *token, std::ostream &oss) const {
-    size_t errorLength = token->value.length();
-    if (token->type & (TokenType::QUOTE1 | TokenType::QUOTE2))
-        errorLength = 1;
+    auto [column, errorLength] = tokenSpan(context, token);
 
     oss << context.filename << ":" << context.lineNumber << ":" << context.columnNumber + 1 << ": ";
-    oss << context.line.substr(0, context.columnNumber) << TERM_COLOR_RED << TERM_BOLD << context.line.substr(context.columnNumber, errorLength) << TERM_COLOR_RESET << context.line.substr(context.columnNumber + errorLength);
+    oss << context.line.substr(0, column) << TERM_COLOR_RED << TERM_BOLD << context.line.substr(column, errorLength) << TERM_COLOR_RESET << context.line.substr(column + errorLength);
 }
 
 void ParserException::_printHint(std::ostream &os) const {
@@ -65,25 +83,26 @@ void ParserException::_printHint(std::ostream &os) const {
     }
 }
 
-void ParserException::_printTraceback(std::ostream &os, const std::vector<ErrorContext> *traceback) const {
-    if (!traceback) traceback = &_traceback;
+void ParserException::_printTraceback(std::ostream &os, const std::vector<const Rule*> *tracebackRules) const {
+    if (!tracebackRules) tracebackRules = &_traceback;
 
-    if (traceback->empty())
+    if (tracebackRules->empty())
         return ;
 
+    std::vector<ErrorContext> traceback;
+    traceback.reserve(tracebackRules->size());
+    for (const Rule *rule : *tracebackRules)
+        traceback.push_back(rule->token->configFile->getErrorContext(rule->token->filePos));
+
     size_t maxFilenameLength = 0;
-    for (const auto &context : *traceback)
+    for (const auto &context : traceback)
         if (context.filename.length() > maxFilenameLength)
             maxFilenameLength = context.filename.length() + 1 + std::to_string(context.lineNumber).length();
 
     os << TERM_COLOR_RED << "Rule Traceback (inclusion chain):" << TERM_COLOR_RESET << "\n";
-    for (const auto &context : *traceback) {
-        size_t lineStart = context.line.find_first_not_of(" \t\r\n");
-        if (lineStart == std::string::npos) continue ;
-
-        std::string trimmedLine = context.line.substr(lineStart);
-        if (!trimmedLine.back()) trimmedLine.pop_back();
-        trimmedLine.erase(trimmedLine.find_last_not_of(" \t\r\n") + 1);
+    for (const auto &context : traceback) {
+        std::string trimmedLine = _trimLine(context.line);
+        if (trimmedLine.empty()) continue ;
 
         size_t filenameLength = context.filename.length() + 1 + std::to_string(context.lineNumber).length();
         os << " → " << context.filename << ":" << context.lineNumber << std::string((maxFilenameLength - filenameLength + 3), ' ') << trimmedLine << "\n";
@@ -92,10 +111,57 @@ void ParserException::_printTraceback(std::ostream &os, const std::vector<ErrorC
     os << "\n";
 }
 
+/// @brief Strip the indentation and the line break (or the NUL that ends the last line of a file) from a line.
+std::string ParserException::_trimLine(const std::string &line) {
+    size_t lineStart = line.find_first_not_of(" \t\r\n");
+    if (lineStart == std::string::npos)
+        return ("");
+
+    std::string trimmedLine = line.substr(lineStart);
+    if (!trimmedLine.back()) trimmedLine.pop_back();
+    trimmedLine.erase(trimmedLine.find_last_not_of(" \t\r\n") + 1);
+    return (trimmedLine);
+}
+
 void ParserException::addTracebackFromRule(Rule *rule) {
-    std::vector<ErrorContext> newTraceback = loadTraceback(rule);
-    _traceback.insert(_traceback.end(), rule->token->configFile->getErrorContext(rule->token->filePos));
-    _traceback.insert(_traceback.end(), newTraceback.begin(), newTraceback.end());
+    std::vector<const Rule*> includeRules = _collectIncludeRules(rule);
+    _traceback.push_back(rule);
+    _traceback.insert(_traceback.end(), includeRules.begin(), includeRules.end());
+}
+
+/// @brief Get the short message of the error, without its context. Use getMessage() for the full report.
+const char *ParserException::what() const noexcept {
+    return (_message.c_str());
+}
+
+/// @brief Get the token the error points at, or nullptr if the error has no location.
+const Token *ParserException::getToken() const {
+    return (nullptr);
+}
+
+/// @brief Get the location of the error as "file:line:column", or an empty string if the error has no location.
+std::string ParserException::getLocation() const {
+    const Token *token = getToken();
+    if (!token || !token->configFile)
+        return ("");
+
+    ErrorContext context = token->configFile->getErrorContext(token->filePos);
+    return (context.filename + ":" + std::to_string(context.lineNumber) + ":" + std::to_string(context.columnNumber + 1));
+}
+
+/// @brief Get the inclusion chain of the error without colors, one "file:line: rule" entry per include rule -
+/// from the innermost to the outermost, like the traceback of getMessage().
+std::vector<std::string> ParserException::getCompactTraceback() const {
+    std::vector<std::string> traceback;
+
+    traceback.reserve(_traceback.size());
+    for (const Rule *rule : _traceback) {
+        ErrorContext context = rule->token->configFile->getErrorContext(rule->token->filePos);
+        std::string trimmedLine = _trimLine(context.line);
+        if (!trimmedLine.empty())
+            traceback.push_back(context.filename + ":" + std::to_string(context.lineNumber) + ": " + trimmedLine);
+    }
+    return (traceback);
 }
 
 std::string ParserException::getMessage() const {
@@ -111,16 +177,16 @@ ParserTokenException::ParserTokenException(const std::string &message, Token *to
     : ParserException(message, hint), _token(token) {}
 
 ParserRuleException::ParserRuleException(const std::string &message, const Rule *rule, const std::string &hint)
-    : ParserException(message, hint, loadTraceback(rule)), _rule(rule) {}
+    : ParserException(message, hint, _collectIncludeRules(rule)), _rule(rule) {}
 
 ParserArgumentException::ParserArgumentException(const std::string &message, const Argument *argument, const std::string &hint)
-    : ParserException(message, hint, loadTraceback(argument->parentRule)), _argument(argument) {}
+    : ParserException(message, hint, _collectIncludeRules(argument->parentRule)), _argument(argument) {}
 
 ParserDuplicateRuleException::ParserDuplicateRuleException(const std::string &message, const Rule *firstRule, const Rule *secondRule, const std::string &hint)
-    : ParserException(message, hint, loadTraceback(secondRule)), _firstRule(firstRule), _secondRule(secondRule), _tracebackFirst(loadTraceback(firstRule)) {}
+    : ParserException(message, hint, _collectIncludeRules(secondRule)), _firstRule(firstRule), _secondRule(secondRule), _tracebackFirst(_collectIncludeRules(firstRule)) {}
 
-ParserMissingException::ParserMissingException(const std::string &message, const std::string &hint)
-    : ParserException(message, hint), _object(nullptr) {}
+ParserMissingException::ParserMissingException(const std::string &message, const Object *object, const std::string &hint)
+    : ParserException(message, hint, _collectIncludeRules(object->parentRule)), _object(object) {}
 
 std::string ParserTokenException::getMessage() const {
     ErrorContext context = _token->configFile->getErrorContext(_token->filePos);
@@ -172,15 +238,7 @@ std::string ParserDuplicateRuleException::getMessage() const {
     return oss.str();
 }
 
-void ParserMissingException::attachObject(const Object *object) {
-    _traceback = loadTraceback(object->parentRule);
-    _object = object;
-}
-
 std::string ParserMissingException::getMessage() const {
-    if (!_object)
-        throw ParserException("ParserMissingException: No object attached", "Attach an object to the exception before calling getMessage()");
-
     std::ostringstream oss;
     oss << TERM_COLOR_RED << "[ParserMissingException]" << TERM_COLOR_RESET << ": " << _message << "\n\n";
 
@@ -196,3 +254,25 @@ std::string ParserMissingException::getMessage() const {
     _printTraceback(oss);
     return oss.str();
 }
+
+const Token *ParserTokenException::getToken() const {
+    return (_token);
+}
+
+const Token *ParserRuleException::getToken() const {
+    return (_rule->token);
+}
+
+const Token *ParserArgumentException::getToken() const {
+    return (_argument->token);
+}
+
+/// @brief The location of a duplicate is its second occurrence - the rule that should be removed.
+const Token *ParserDuplicateRuleException::getToken() const {
+    return (_secondRule->token);
+}
+
+/// @brief The location of a missing rule is the object it is missing from.
+const Token *ParserMissingException::getToken() const {
+    return (_object->objectOpenToken);
+}
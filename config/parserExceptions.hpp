@@ -7,24 +7,35 @@
 
 #define DUPLICATE_RULE
 
+/// @brief The base of all configuration errors. Exceptions only keep pointers to the tokens and rules of the error:
+/// the lines of the files are looked up when the message is rendered by getMessage(), so an exception that is
+/// caught and discarded never touches the file content.
+/// @note The pointers point into the arena of the parser, so the message has to be rendered before the parser is destroyed.
 class ParserException : public std::exception {
 protected:
     std::string _message;
     std::string _hint;
-    std::vector<ErrorContext> _traceback;
+    std::vector<const Rule*> _traceback;
+
+    static std::vector<const Rule*> _collectIncludeRules(const Rule *rule);
+    static std::string _trimLine(const std::string &line);
 
     void _printErrorContext(const ErrorContext &context, const Token *token, std::ostream &os) const;
     void _printCompactErrorContext(const ErrorContext &context, const Token *token, std::ostream &os) const;
     void _printHint(std::ostream &os) const;
-    void _printTraceback(std::ostream &os, const std::vector<ErrorContext> *traceback = nullptr) const;
+    void _printTraceback(std::ostream &os, const std::vector<const Rule*> *traceback = nullptr) const;
 
 public:
     ParserException(const std::string &message, const std::string &hint = "");
-    ParserException(const std::string &message, const std::string &hint, std::vector<ErrorContext> traceback);
+    ParserException(const std::string &message, const std::string &hint, std::vector<const Rule*> traceback);
     virtual ~ParserException() noexcept = default;
 
     void addTracebackFromRule(Rule *rule);
     virtual std::string getMessage() const;
+    virtual const Token *getToken() const;
+    std::string getLocation() const;
+    std::vector<std::string> getCompactTraceback() const;
+    const char *what() const noexcept override;
 };
 
 class ParserTokenException : public ParserException {
@@ -35,6 +46,7 @@ public:
     ParserTokenException(const std::string &message, Token *token, const std::string &hint = "");
 
     std::string getMessage() const override;
+    const Token *getToken() const override;
 
 };
 
@@ -46,6 +58,7 @@ public:
     ParserRuleException(const std::string &message, const Rule *rule, const std::string &hint = "");
 
     std::string getMessage() const override;
+    const Token *getToken() const override;
 };
 
 class ParserArgumentException : public ParserException {
@@ -56,18 +69,20 @@ public:
     ParserArgumentException(const std::string &message, const Argument *argument, const std::string &hint = "");
 
     std::string getMessage() const override;
+    const Token *getToken() const override;
 };
 
 class ParserDuplicateRuleException : public ParserException {
 private:
     const Rule *_firstRule;
     const Rule *_secondRule;
-    std::vector<ErrorContext> _tracebackFirst;
+    std::vector<const Rule*> _tracebackFirst;
 
 public:
     ParserDuplicateRuleException(const std::string &message, const Rule *firstRule, const Rule *secondRule, const std::string &hint = "");
 
     std::string getMessage() const override;
+    const Token *getToken() const override;
 };
 
 class ParserMissingException : public ParserException {
@@ -75,8 +90,8 @@ private:
     const Object *_object;
 
 public:
-    ParserMissingException(const std::string &message, const std::string &hint = "");
+    ParserMissingException(const std::string &message, const Object *object, const std::string &hint = "");
 
-    void attachObject(const Object *object);
     std::string getMessage() const override;
+    const Token *getToken() const override;
 };
\ No newline at end of file
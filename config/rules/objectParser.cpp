@@ -1,26 +1,34 @@
 #include "objectParser.hpp"
 
 #include <vector>
+#include <span>
 
+/// @param object The object to parse, or nullptr after an error was reported - the parser then does nothing.
 ObjectParser::ObjectParser(Object *object)
-    : _object(object) {}
+    : _object(object),
+    _diagnostics(object ? DiagnosticSink::of(object->objectOpenToken) : nullptr),
+    _reportedErrors(DiagnosticSink::countOf(_diagnostics)) {}
 
 /// @brief Fetch rules for a given key from the current object and its parent objects.
 /// The rules are fetched in a depth-first manner, starting from the current object and going up
 /// through its parent rules - taking into account the specified scope
 /// @param key The key for which the rules are being fetched.
-/// @return A vector of pointers to the rules that match the given key. The rules are ordered from the least specific (global scope) to the most specific (local scope).
-std::vector<Rule*> ObjectParser::_fetchRules(Key key) {
-    std::vector<Rule*> rules;
+/// @return A view of the rules that match the given key. The rules are ordered from the least specific (global scope) to the most specific (local scope).
+/// @note The view points either into the object tree or into a buffer of the parser, so it is only valid until the next fetch.
+std::span<Rule* const> ObjectParser::_fetchRules(Key key) {
     Object *object = _object;
+    size_t ruleCount = 0;
 
+    _scopeBuffer.clear();
     while (object) {
         auto it = object->rules.find(key);
-        if (it != object->rules.end())
-            rules.insert(rules.begin(), it->second.begin(), it->second.end());
+        if (it != object->rules.end() && !it->second.empty()) {
+            _scopeBuffer.emplace_back(it->second);
+            ruleCount += it->second.size();
+        }
 
         if (!object->parentRule
-            || (_expectedRuleCount == ExpectedRuleCount::ONE && rules.size())
+            || (_expectedRuleCount == ExpectedRuleCount::ONE && ruleCount)
             || (_scopeFallback == RulesScope::BOUND && _bound_fallback == object->parentRule->key)
             || _scopeFallback == RulesScope::LOCAL)
             break ;
@@ -28,11 +36,22 @@ std::vector<Rule*> ObjectParser::_fetchRules(Key key) {
         object = object->parentRule->parentObject;
     }
 
+    std::span<Rule* const> rules;
+    if (_scopeBuffer.size() == 1)
+        rules = _scopeBuffer.front();
+    else if (_scopeBuffer.size() > 1) {
+        _ruleBuffer.clear();
+        _ruleBuffer.reserve(ruleCount);
+        for (auto scope = _scopeBuffer.rbegin(); scope != _scopeBuffer.rend(); ++scope)
+            _ruleBuffer.insert(_ruleBuffer.end(), scope->begin(), scope->end());
+        rules = _ruleBuffer;
+    }
+
     if (rules.empty() && !_optional)
-        throw ParserMissingException("Missing rule for key: " + std::to_string(static_cast<int>(key)), 
+        DiagnosticSink::report<ParserMissingException>(_diagnostics, "Missing rule for key: " + std::to_string(static_cast<int>(key)), _object,
             "Check the configuration file for the required rule.");
-    if (_expectedRuleCount == ExpectedRuleCount::ONE && rules.size() > 1)
-        throw ParserDuplicateRuleException("Duplicated rule found", rules[0], rules[1],
+    else if (_expectedRuleCount == ExpectedRuleCount::ONE && rules.size() > 1)
+        DiagnosticSink::report<ParserDuplicateRuleException>(_diagnostics, "Duplicated rule found", rules[0], rules[1],
             "Remove the duplicate rule outside of its scope to avoid conflicts.");
 
     return (rules);
@@ -74,3 +93,10 @@ ObjectParser& ObjectParser::required() {
     _optional = false;
     return (*this);
 }
+
+/// @brief Check if an error was reported while parsing the object (or if there was no object to parse).
+/// Once failed, every parse call of this parser does nothing.
+/// @note Errors are only collected when the file has a diagnostic sink - without one they are thrown.
+bool ObjectParser::failed() const {
+    return (!_object || DiagnosticSink::countOf(_diagnostics) != _reportedErrors);
+}
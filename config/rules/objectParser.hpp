@@ -1,8 +1,11 @@
 #pragma once
 
 #include "../parserExceptions.hpp"
+#include "../diagnostics.hpp"
 
+#include <vector>
 #include <string>
+#include <span>
 
 enum RulesScope {
     LOCAL = 0,
@@ -22,13 +25,18 @@ private:
     Key _bound_fallback = Key::NO_KEY;
     bool _optional = false;
     Object *_object;
+    DiagnosticSink *_diagnostics;
+    size_t _reportedErrors;
 
-    std::vector<Rule*> _fetchRules(Key key);
+    std::vector<std::span<Rule* const>> _scopeBuffer;
+    std::vector<Rule*> _ruleBuffer;
+
+    std::span<Rule* const> _fetchRules(Key key);
 
 public:
     ObjectParser(Object *object);
-    ObjectParser(const ObjectParser&) = default;
-    ObjectParser& operator=(const ObjectParser&) = default;
+    ObjectParser(const ObjectParser&) = delete;
+    ObjectParser& operator=(const ObjectParser&) = delete;
     ~ObjectParser() = default;
 
     ObjectParser& local();
@@ -37,6 +45,8 @@ public:
     ObjectParser& optional();
     ObjectParser& required();
 
+    bool failed() const;
+
     /// @brief Parse a single target class from a single rule.
     /// @tparam T The target class type that will be parsed from the rule.
     /// @param target The target class instance that will be filled with the parsed rule data.
@@ -45,16 +55,12 @@ public:
     ObjectParser& parseFromOne(T& target) {
         _expectedRuleCount = ExpectedRuleCount::ONE;
 
-        Key key = T::getKey();
-        std::vector<Rule*> rules;
-        try { rules = _fetchRules(key); }
-        catch (ParserMissingException &e) {
-            e.attachObject(_object);
-            throw;
-        }
+        if (failed())
+            return (*this);
+        std::span<Rule* const> rules = _fetchRules(T::getKey());
 
-        if (rules.empty()) target = std::move(T(nullptr));
-        else target = std::move(T(rules[0]));
+        if (!failed())
+            target = T(rules.empty() ? nullptr : rules[0]);
 
         return (*this);
     }
@@ -67,20 +73,17 @@ public:
     ObjectParser& parseFromRange(T &target) {
         _expectedRuleCount = ExpectedRuleCount::MULTIPLE;
 
-        Key key = T::getKey();
-        std::vector<Rule*> rules;
-        try { rules = _fetchRules(key); }
-        catch (ParserMissingException &e) {
-            e.attachObject(_object);
-            throw;
-        }
+        if (failed())
+            return (*this);
+        std::span<Rule* const> rules = _fetchRules(T::getKey());
 
-        target = std::move(T(rules));
+        if (!failed())
+            target = T(rules);
 
         return (*this);
     }
 
-    /// @brief Parse a range of target classes from multiple rules.
+    /// @brief Parse a range of target classes from multiple rules - every target is constructed in place.
     /// @tparam T The target class type that will be parsed from the rules.
     /// @param target The target vector that will be filled with the parsed rule data.
     /// @return A reference to the current ObjectParser instance for method chaining.
@@ -88,16 +91,13 @@ public:
     ObjectParser& parseRange(std::vector<T>& target) {
         _expectedRuleCount = ExpectedRuleCount::MULTIPLE;
 
-        Key key = T::getKey();
-        std::vector<Rule*> rules;
-        try { rules = _fetchRules(key); }
-        catch (ParserMissingException &e) {
-            e.attachObject(_object);
-            throw;
-        }
+        if (failed())
+            return (*this);
+        std::span<Rule* const> rules = _fetchRules(T::getKey());
 
-        for (Rule* rule : rules)
-            target.emplace_back(T(rule));
+        target.reserve(target.size() + rules.size());
+        for (auto it = rules.begin(); it != rules.end() && !failed(); ++it)
+            target.emplace_back(*it);
 
         return (*this);
     }
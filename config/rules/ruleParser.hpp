@@ -2,9 +2,11 @@
 
 #include "../types/argumentConverter.hpp"
 #include "../parserExceptions.hpp"
+#include "../diagnostics.hpp"
 #include "baserule.hpp"
 
 #include <string>
+#include <any>
 
 class BaseRule;
 
@@ -15,6 +17,24 @@ private:
     std::string _ruleFormat;
 
     size_t _argumentIndex = 0;
+    DiagnosticSink *_diagnostics;
+    size_t _reportedErrors;
+
+    void _reportNotEnoughArguments();
+
+    /// @brief Convert an argument, or reuse the value of an earlier conversion to the same type.
+    /// Rules of outer scopes are parsed again for every server and location they apply to, so the result is cached in the argument.
+    /// @return The converted value, or nullptr if the conversion reported an error.
+    template <typename T>
+    const T *_convert(Argument *argument) {
+        if (const T *cached = std::any_cast<T>(&argument->converted))
+            return (cached);
+
+        T value = ArgumentConverter<T, Argument*>::convert(argument);
+        if (failed())
+            return (nullptr);
+        return (&argument->converted.emplace<T>(std::move(value)));
+    }
 
 public:
     RuleParser(Rule* rule, const std::string &name, const std::string &format);
@@ -29,33 +49,48 @@ public:
     RuleParser& expectArgumentCount(size_t min, size_t max);
     RuleParser& expectArgumentCount(size_t count);
 
+    bool failed() const;
+
     template <typename T>
     RuleParser& parseArgument(T &target) {
-        if (_argumentIndex >= _rule->arguments.size())
-            throw ParserRuleException("Not enough arguments provided for rule '" + _ruleName + "'", _rule,
-                "Check the syntax of the rule. Expected format:\n\t" + _ruleFormat);
-
-        target = std::move(ArgumentConverter<T, Argument*>::convert(_rule->arguments[_argumentIndex++]));
+        if (failed())
+            return (*this);
+        if (_argumentIndex >= _rule->arguments.size()) {
+            _reportNotEnoughArguments();
+            return (*this);
+        }
+
+        if (const T *value = _convert<T>(_rule->arguments[_argumentIndex++]))
+            target = *value;
         return (*this);
     }
 
     template <typename T>
     RuleParser& parseOptionalArgument(T &target) {
-        if (_argumentIndex < _rule->arguments.size())
-            target = std::move(ArgumentConverter<T, Argument*>::convert(_rule->arguments[_argumentIndex++]));
+        if (failed() || _argumentIndex >= _rule->arguments.size())
+            return (*this);
 
+        if (const T *value = _convert<T>(_rule->arguments[_argumentIndex++]))
+            target = *value;
         return (*this);
     }
 
     template <typename T>
     RuleParser& parseAllButX(std::vector<T> &target, size_t argumentsToSave) {
-        if (argumentsToSave >= _rule->arguments.size() - _argumentIndex)
-            throw ParserRuleException("Not enough arguments provided for rule '" + _ruleName + "'", _rule,
-                "Check the syntax of the rule. Expected format:\n\t" + _ruleFormat);
+        if (failed())
+            return (*this);
+        if (argumentsToSave >= _rule->arguments.size() - _argumentIndex) {
+            _reportNotEnoughArguments();
+            return (*this);
+        }
         size_t argumentsToParse = _rule->arguments.size() - _argumentIndex - argumentsToSave;
 
-        for (size_t i = 0; i < argumentsToParse; ++i)
-            target.emplace_back(ArgumentConverter<T, Argument*>::convert(_rule->arguments[_argumentIndex++]));
+        for (size_t i = 0; i < argumentsToParse; ++i) {
+            const T *value = _convert<T>(_rule->arguments[_argumentIndex++]);
+            if (!value)
+                break ;
+            target.emplace_back(*value);
+        }
         return (*this);
     }
 
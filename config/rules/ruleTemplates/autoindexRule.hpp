@@ -20,6 +20,8 @@ public:
 
     AutoIndexRule(const AutoIndexRule &other) = default;
     AutoIndexRule& operator=(const AutoIndexRule &other) = default;
+    AutoIndexRule(AutoIndexRule &&other) = default;
+    AutoIndexRule& operator=(AutoIndexRule &&other) = default;
     ~AutoIndexRule() = default;
     
     AutoIndexRule();
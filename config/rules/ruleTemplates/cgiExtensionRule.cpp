@@ -2,38 +2,84 @@
 #include "../ruleParser.hpp"
 #include "../rules.hpp"
 
-CgiExtensionRule::CgiExtensionRule(std::vector<Rule *> &rules) {
+#include <cstring>
+
+/// @brief Pack an extension of at most CGI_PACKED_EXTENSION_LENGTH characters into an integer, padded with zero bytes.
+/// As extensions cannot contain NUL bytes, two extensions are equal if and only if their packed values are equal.
+static uint64_t packExtension(std::string_view extension) {
+    uint64_t packed = 0;
+    std::memcpy(&packed, extension.data(), extension.length());
+    return (packed);
+}
+
+CgiExtensionRule::CgiExtensionRule(std::span<Rule* const> rules) {
     for (Rule *rule : rules) {
+        std::vector<CgiExtension> extensions;
+
         RuleParser::create(rule, *this)
             .expectMinNumArguments(1)
-            .parseAll(_extensions);
+            .parseAll(extensions);
+
+        for (CgiExtension &extension : extensions)
+            _addExtension(std::move(extension));
     }
 }
 
+/// @brief Add an extension to the matcher. As rules are parsed from the least to the most specific scope,
+/// redefining an extension overrides its interpreter.
+void CgiExtensionRule::_addExtension(CgiExtension &&extension) {
+    for (CgiExtension &existing : _extensions) {
+        if (existing.extension == extension.extension) {
+            existing.interpreter = std::move(extension.interpreter);
+            return ;
+        }
+    }
+
+    _packedExtensions.push_back(extension.extension.length() <= CGI_PACKED_EXTENSION_LENGTH ? packExtension(extension.extension.str()) : 0);
+    _extensions.push_back(std::move(extension));
+}
+
 /// @brief Check if the CGI extension rule is set (i.e., if it contains any extensions).
 bool CgiExtensionRule::isSet() const {
     return (!_extensions.empty());
 }
 
 /// @brief Get the list of CGI extensions defined by this rule.
-const std::vector<std::string>& CgiExtensionRule::getExtensions() const {
+const std::vector<CgiExtension>& CgiExtensionRule::getExtensions() const {
     return (_extensions);
 }
 
+/// @brief Find the CGI extension of a filesystem path, scanning the path once from the end without allocating.
+/// @param path The path to check - it should not contain a query string.
+/// @return The matching extension with its interpreter, or nullptr if the path has no CGI extension.
+const CgiExtension* CgiExtensionRule::match(std::string_view path) const {
+    if (_extensions.empty())
+        return (nullptr);
+
+    size_t dotPos = path.find_last_of("./");
+    if (dotPos == std::string_view::npos || path[dotPos] != '.' || dotPos + 1 == path.length())
+        return (nullptr);
+
+    std::string_view extension = path.substr(dotPos + 1);
+    if (extension.length() <= CGI_PACKED_EXTENSION_LENGTH) {
+        uint64_t packed = packExtension(extension);
+        for (size_t i = 0; i < _packedExtensions.size(); ++i)
+            if (_packedExtensions[i] == packed)
+                return (&_extensions[i]);
+        return (nullptr);
+    }
+
+    for (const CgiExtension &candidate : _extensions)
+        if (candidate.extension.str() == extension)
+            return (&candidate);
+    return (nullptr);
+}
+
 /// @brief Check if a given path has a CGI extension defined by this rule.
 /// @param path The path to check.
 /// @return True if the path has a CGI extension defined by this rule, false otherwise.
 bool CgiExtensionRule::isCGI(const Path &path) const {
-    if (_extensions.empty())
-        return (false);
-
-    std::string filename = path.getFilename();
-    size_t lastDotPos = filename.find_first_of('.', filename.find_first_of('?'));
-    if (lastDotPos == std::string::npos)
-        return (false);
-
-    std::string extension = filename.substr(lastDotPos + 1, filename.find_first_of('?') - lastDotPos - 1);
-    return std::find(_extensions.begin(), _extensions.end(), extension) != _extensions.end();
+    return (match(path.str()) != nullptr);
 }
 
 std::ostream& operator<<(std::ostream &os, const CgiExtensionRule &rule) {
@@ -41,7 +87,10 @@ std::ostream& operator<<(std::ostream &os, const CgiExtensionRule &rule) {
     if (rule.isSet()) {
         os << "Extensions: ";
         for (const auto &ext : rule.getExtensions()) {
-            os << ext << " ";
+            os << "." << ext.extension;
+            if (!ext.interpreter.empty())
+                os << "=" << ext.interpreter;
+            os << " ";
         }
     } else {
         os << "No extensions set";
@@ -4,27 +4,39 @@
 #include "../../config.hpp"
 #include "../baserule.hpp"
 
+#include <string_view>
+#include <cstdint>
 #include <vector>
+#include <span>
 #include <string>
 
+/// Extensions up to this length are packed into a single integer for matching.
+#define CGI_PACKED_EXTENSION_LENGTH sizeof(uint64_t)
+
 class CgiExtensionRule : public BaseRule {
 private:
-    std::vector<std::string> _extensions;
+    std::vector<CgiExtension> _extensions;
+    std::vector<uint64_t> _packedExtensions;
+
+    void _addExtension(CgiExtension &&extension);
 
 public:
     constexpr static Key getKey() { return Key::CGI_EXTENSION; }
     constexpr static const std::string getRuleName() { return "cgi_extension"; }
-    constexpr static const std::string getRuleFormat() { return CgiExtensionRule::getRuleName() + " <ext1> [<ext2> ...]"; }
+    constexpr static const std::string getRuleFormat() { return CgiExtensionRule::getRuleName() + " <ext1>[=<interpreter>] [<ext2>[=<interpreter>] ...]"; }
 
     CgiExtensionRule(const CgiExtensionRule &other) = default;
     CgiExtensionRule& operator=(const CgiExtensionRule &other) = default;
+    CgiExtensionRule(CgiExtensionRule &&other) = default;
+    CgiExtensionRule& operator=(CgiExtensionRule &&other) = default;
     ~CgiExtensionRule() = default;
     
     CgiExtensionRule() = default;
-    CgiExtensionRule(std::vector<Rule *> &rules);
+    CgiExtensionRule(std::span<Rule* const> rules);
 
     bool isSet() const;
-    const std::vector<std::string>& getExtensions() const;
+    const std::vector<CgiExtension>& getExtensions() const;
+    const CgiExtension* match(std::string_view path) const;
     bool isCGI(const Path &path) const;
 };
 
@@ -21,6 +21,8 @@ public:
 
     CgiRule(const CgiRule &other) = default;
     CgiRule& operator=(const CgiRule &other) = default;
+    CgiRule(CgiRule &&other) = default;
+    CgiRule& operator=(CgiRule &&other) = default;
     ~CgiRule() = default;
 
     CgiRule();
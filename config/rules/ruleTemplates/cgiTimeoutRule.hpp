@@ -22,6 +22,8 @@ public:
 
     CgiTimeoutRule(const CgiTimeoutRule &other) = default;
     CgiTimeoutRule& operator=(const CgiTimeoutRule &other) = default;
+    CgiTimeoutRule(CgiTimeoutRule &&other) = default;
+    CgiTimeoutRule& operator=(CgiTimeoutRule &&other) = default;
     ~CgiTimeoutRule() = default;
     
     CgiTimeoutRule();
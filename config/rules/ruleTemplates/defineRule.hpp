@@ -20,6 +20,8 @@ public:
 
     DefineRule(const DefineRule &other) = default;
     DefineRule& operator=(const DefineRule &other) = default;
+    DefineRule(DefineRule &&other) = default;
+    DefineRule& operator=(DefineRule &&other) = default;
     ~DefineRule() = default;
     
     DefineRule() = delete;
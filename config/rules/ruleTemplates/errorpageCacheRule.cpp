@@ -0,0 +1,35 @@
+#include "errorpageCacheRule.hpp"
+#include "../ruleParser.hpp"
+#include "../rules.hpp"
+
+#include <ostream>
+
+ErrorPageCacheRule::ErrorPageCacheRule() :
+    _isSet(false), _enabled(ERROR_PAGE_CACHE_DEFAULT) {}
+
+ErrorPageCacheRule::ErrorPageCacheRule(Rule *rule) :
+    _isSet(false), _enabled(ERROR_PAGE_CACHE_DEFAULT)
+{
+    if (!rule) return ;
+
+    RuleParser::create(rule, *this)
+        .expectArgumentCount(1)
+        .parseArgument(_enabled);
+
+    _isSet = true;
+}
+
+/// @brief Check if the error page cache rule is set (i.e., if it has been parsed and contains a valid value).
+bool ErrorPageCacheRule::isSet() const {
+    return _isSet;
+}
+
+/// @brief Check if the error responses of the location should be preloaded into memory.
+bool ErrorPageCacheRule::isEnabled() const {
+    return _enabled;
+}
+
+std::ostream& operator<<(std::ostream &os, const ErrorPageCacheRule &rule) {
+    os << "ErrorPageCacheRule: " << (rule.isEnabled() ? "on" : "off");
+    return os;
+}
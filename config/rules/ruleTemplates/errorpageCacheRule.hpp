@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../../config.hpp"
+#include "../baserule.hpp"
+
+#include <ostream>
+#include <string>
+
+#define ERROR_PAGE_CACHE_DEFAULT false
+
+class ErrorPageCacheRule : public BaseRule {
+private:
+    bool _isSet;
+    bool _enabled;
+
+public:
+    constexpr static Key getKey() { return Key::ERROR_PAGE_CACHE; }
+    constexpr static const std::string getRuleName() { return "error_page_cache"; }
+    constexpr static const std::string getRuleFormat() { return ErrorPageCacheRule::getRuleName() + " <on|off>"; }
+
+    ErrorPageCacheRule(const ErrorPageCacheRule &other) = default;
+    ErrorPageCacheRule& operator=(const ErrorPageCacheRule &other) = default;
+    ErrorPageCacheRule(ErrorPageCacheRule &&other) = default;
+    ErrorPageCacheRule& operator=(ErrorPageCacheRule &&other) = default;
+    ~ErrorPageCacheRule() = default;
+
+    ErrorPageCacheRule();
+    ErrorPageCacheRule(Rule *rule);
+
+    bool isSet() const;
+    bool isEnabled() const;
+};
+
+std::ostream& operator<<(std::ostream &os, const ErrorPageCacheRule &rule);
\ No newline at end of file
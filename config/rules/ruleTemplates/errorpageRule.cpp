@@ -2,13 +2,61 @@
 #include "../ruleParser.hpp"
 #include "../rules.hpp"
 
+#include <fstream>
+#include <sstream>
 #include <ostream>
 #include <vector>
 #include <map>
 
+/// @brief Get the preloaded response for a status code, building it on first use.
+/// @param code The status code of the response.
+/// @param page The error page to use as body, or nullptr to use the default body for the status code.
+/// @return The shared response, or nullptr if the status code is unknown.
+std::shared_ptr<const ErrorResponse> ErrorResponseCache::get(HttpStatusCode code, const Path *page) {
+    const char *reason = getStatusCodeReason(code);
+    if (!reason)
+        return nullptr;
+
+    auto key = std::make_pair(static_cast<int>(code), page ? page->str() : std::string());
+    auto it = _responses.find(key);
+    if (it != _responses.end())
+        return it->second;
+
+    std::shared_ptr<ErrorResponse> response = std::make_shared<ErrorResponse>();
+    const char *contentType = "text/plain";
+
+    std::ifstream file;
+    if (page)
+        file.open(page->str(), std::ios::binary);
+    if (file.is_open()) {
+        std::ostringstream content;
+        content << file.rdbuf();
+        response->body = content.str();
+        contentType = "text/html";
+    } else {
+        if (page)
+            _unreadablePages.insert(page->str());
+        response->body = getDefaultBodyForCode(code);
+    }
+
+    response->contentLength = response->body.length();
+    response->header = "HTTP/1.1 " + std::to_string(static_cast<int>(code)) + " " + reason + "\r\n"
+        + headerKeyToString(HeaderKey::ContentType) + ": " + contentType + "\r\n"
+        + headerKeyToString(HeaderKey::ContentLength) + ": " + std::to_string(response->contentLength) + "\r\n\r\n";
+
+    _responses.emplace(std::move(key), response);
+    return response;
+}
+
+/// @brief Get the error pages that could not be read - their responses got the default body instead.
+const std::set<std::string> &ErrorResponseCache::getUnreadablePages() const {
+    return (_unreadablePages);
+}
+
 /// @brief Add a single error page rule to the error pages map, overwriting any existing entry for the same error code.
 /// @param rule The rule to be added, which should contain at least one error code and a path to the error page.
-void ErrorPageRule::_addSingleRule(Rule *rule) {
+/// @param errorPages The map the error pages are added to.
+void ErrorPageRule::_addSingleRule(Rule *rule, std::map<StatusCode, Path> &errorPages) {
     std::vector<StatusCode> errorCodes;
     Path errorPagePath;
 
@@ -18,38 +66,87 @@ void ErrorPageRule::_addSingleRule(Rule *rule) {
         .parseArgument(errorPagePath);
 
     for (StatusCode code : errorCodes)
-        _errorPages[code] = errorPagePath;
+        errorPages[code] = errorPagePath;
 }
 
-ErrorPageRule::ErrorPageRule(std::vector<Rule*> &rules) {
+ErrorPageRule::ErrorPageRule(std::span<Rule* const> rules) {
+    if (rules.empty())
+        return ;
+
+    std::shared_ptr<ErrorPageTable> table = std::make_shared<ErrorPageTable>();
     for (Rule *rule : rules)
-        _addSingleRule(rule);
+        _addSingleRule(rule, table->errorPages);
+
+    auto wildcardIt = table->errorPages.find(StatusCode::Wildcard());
+    table->wildcard = (wildcardIt != table->errorPages.end()) ? &wildcardIt->second : nullptr;
+    table->lookup.fill(table->wildcard);
+
+    for (const auto &[code, path] : table->errorPages)
+        if (code.value >= ERROR_PAGE_TABLE_FIRST_CODE)
+            table->lookup[code.value - ERROR_PAGE_TABLE_FIRST_CODE] = &path;
+
+    _table = std::move(table);
 }
 
 /// @brief Check if the error page rule is set (i.e., if it contains any error pages).
 bool ErrorPageRule::isSet() const {
-    return (!_errorPages.empty());
+    return (_table && !_table->errorPages.empty());
 }
 
 /// @brief Get the map of error pages, where keys are error codes and values are paths to the corresponding error pages.
 const std::map<StatusCode, Path>& ErrorPageRule::getErrorPages() const {
-    return _errorPages;
+    static const std::map<StatusCode, Path> noErrorPages;
+
+    if (!_table)
+        return noErrorPages;
+    return _table->errorPages;
 }
 
 /// @brief Get the error page path for a specific error code.
 /// @param code The error code for which the error page is requested.
 /// @return The path to the error page associated with the given error code, or an empty string if the code is not found.
-/// If the code is StatusCode::Wildcard(), it returns the first error page found in the map.
-std::string ErrorPageRule::getErrorPage(StatusCode code) const {
-    auto it = _errorPages.find(code);
-    if (it != _errorPages.end())
-        return it->second.str();
+/// Codes without their own error page fall back to the wildcard error page, if one is set.
+const std::string& ErrorPageRule::getErrorPage(StatusCode code) const {
+    static const std::string noErrorPage;
+
+    if (!_table)
+        return noErrorPage;
+
+    const Path *page = _table->wildcard;
+    if (code.value >= ERROR_PAGE_TABLE_FIRST_CODE && code.value < ERROR_PAGE_TABLE_FIRST_CODE + ERROR_PAGE_TABLE_SIZE)
+        page = _table->lookup[code.value - ERROR_PAGE_TABLE_FIRST_CODE];
+
+    return (page ? page->str() : noErrorPage);
+}
+
+/// @brief Get the preloaded response for a status code.
+/// @param code The status code of the response.
+/// @return The response, or nullptr if the error pages are not preloaded or the status code is unknown.
+const ErrorResponse* ErrorPageRule::getErrorResponse(StatusCode code) const {
+    if (!_responses || code.value < ERROR_PAGE_TABLE_FIRST_CODE || code.value >= ERROR_PAGE_TABLE_FIRST_CODE + ERROR_PAGE_TABLE_SIZE)
+        return nullptr;
+    return _responses->responses[code.value - ERROR_PAGE_TABLE_FIRST_CODE];
+}
 
-    auto wildcardIt = _errorPages.find(StatusCode::Wildcard());
-    if (wildcardIt != _errorPages.end())
-        return wildcardIt->second.str();
+/// @brief Load the error pages of every known status code into memory, together with a prebuilt header block.
+/// Status codes without an error page get the default body. The responses live as long as the configuration,
+/// so reloading the configuration also reloads the error pages.
+/// @param cache The cache used to share responses between the locations of a configuration.
+void ErrorPageRule::preload(ErrorResponseCache &cache) {
+    std::shared_ptr<ErrorResponseTable> responses = std::make_shared<ErrorResponseTable>();
+    responses->responses.fill(nullptr);
+
+    for (int i = 0; i < ERROR_PAGE_TABLE_SIZE; ++i) {
+        const Path *page = _table ? _table->lookup[i] : nullptr;
+        std::shared_ptr<const ErrorResponse> response = cache.get(static_cast<HttpStatusCode>(ERROR_PAGE_TABLE_FIRST_CODE + i), page);
+        if (!response)
+            continue;
+
+        responses->responses[i] = response.get();
+        responses->owners.push_back(std::move(response));
+    }
 
-    return "";
+    _responses = std::move(responses);
 }
 
 std::ostream& operator<<(std::ostream &os, const ErrorPageRule &rule) {
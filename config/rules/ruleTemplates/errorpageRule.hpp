@@ -1,18 +1,61 @@
 #pragma once
 
 #include "../../types/customTypes.hpp"
+#include "../../types/consts.hpp"
 #include "../../config.hpp"
 #include "../baserule.hpp"
 
 #include <vector>
+#include <span>
 #include <string>
+#include <memory>
+#include <array>
 #include <map>
+#include <set>
+
+#define ERROR_PAGE_TABLE_FIRST_CODE 100
+#define ERROR_PAGE_TABLE_SIZE 500
+
+/// @brief The compiled error pages of a location, shared between copies of the rule.
+/// The lookup table is indexed by (status code - 100) and already has the wildcard page folded in.
+struct ErrorPageTable {
+    std::map<StatusCode, Path> errorPages;
+    std::array<const Path*, ERROR_PAGE_TABLE_SIZE> lookup;
+    const Path *wildcard;
+};
+
+/// @brief A fully prepared error response: the header block (status line, Content-Type and Content-Length) and the body.
+struct ErrorResponse {
+    std::string header;
+    std::string body;
+    size_t contentLength;
+};
+
+/// @brief The preloaded error responses of a location, indexed like ErrorPageTable::lookup.
+/// Entries for unknown status codes are nullptr.
+struct ErrorResponseTable {
+    std::array<const ErrorResponse*, ERROR_PAGE_TABLE_SIZE> responses;
+    std::vector<std::shared_ptr<const ErrorResponse>> owners;
+};
+
+/// @brief Deduplicates preloaded error responses while building a configuration, so locations sharing the
+/// same error pages share the same responses and every error page is only read from disk once.
+class ErrorResponseCache {
+private:
+    std::map<std::pair<int, std::string>, std::shared_ptr<const ErrorResponse>> _responses;
+    std::set<std::string> _unreadablePages;
+
+public:
+    std::shared_ptr<const ErrorResponse> get(HttpStatusCode code, const Path *page);
+    const std::set<std::string> &getUnreadablePages() const;
+};
 
 class ErrorPageRule : public BaseRule {
 private:
-    std::map<StatusCode, Path> _errorPages;
+    std::shared_ptr<const ErrorPageTable> _table;
+    std::shared_ptr<const ErrorResponseTable> _responses;
 
-    void _addSingleRule(Rule *rule);
+    void _addSingleRule(Rule *rule, std::map<StatusCode, Path> &errorPages);
 
 public:
     constexpr static Key getKey() { return Key::ERROR_PAGE; }
@@ -21,12 +64,16 @@ public:
 
     ErrorPageRule(const ErrorPageRule &other) = default;
     ErrorPageRule& operator=(const ErrorPageRule &other) = default;
+    ErrorPageRule(ErrorPageRule &&other) = default;
+    ErrorPageRule& operator=(ErrorPageRule &&other) = default;
     ~ErrorPageRule() = default;
     
     ErrorPageRule() = default;
-    ErrorPageRule(std::vector<Rule*> &rules);
+    ErrorPageRule(std::span<Rule* const> rules);
 
-    std::string getErrorPage(StatusCode code) const;
+    const std::string& getErrorPage(StatusCode code) const;
+    const ErrorResponse* getErrorResponse(StatusCode code) const;
+    void preload(ErrorResponseCache &cache);
 
     bool isSet() const;
     const std::map<StatusCode, Path>& getErrorPages() const;
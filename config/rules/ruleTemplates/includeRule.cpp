@@ -15,6 +15,11 @@ const std::string& IncludeRule::getIncludePath() const {
     return _includePath;
 }
 
+/// @brief Check if the include path is a glob pattern (e.g. conf.d/*.conf) instead of a single file or define.
+bool IncludeRule::isPattern() const {
+    return (_includePath.find_first_of("*?[") != std::string::npos);
+}
+
 /// @brief Check if the include rule is set (i.e., if it has a non-empty include path).
 bool IncludeRule::isSet() const {
     return (!_includePath.empty());
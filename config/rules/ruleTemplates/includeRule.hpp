@@ -13,16 +13,19 @@ private:
 public:
     constexpr static Key getKey() { return Key::INCLUDE; }
     constexpr static const std::string getRuleName() { return "include"; }
-    constexpr static const std::string getRuleFormat() { return IncludeRule::getRuleName() + " <path | name>"; }
+    constexpr static const std::string getRuleFormat() { return IncludeRule::getRuleName() + " <path | pattern | name>"; }
 
     IncludeRule(const IncludeRule &other) = default;
     IncludeRule& operator=(const IncludeRule &other) = default;
+    IncludeRule(IncludeRule &&other) = default;
+    IncludeRule& operator=(IncludeRule &&other) = default;
     ~IncludeRule() = default;
 
     IncludeRule() = delete;
     IncludeRule(Rule *rule);
 
     const std::string& getIncludePath() const;
+    bool isPattern() const;
     bool isSet() const;
 };
 
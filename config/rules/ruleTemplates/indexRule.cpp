@@ -5,7 +5,7 @@
 #include <ostream>
 #include <vector>
 
-IndexRule::IndexRule(std::vector<Rule *> &rules) {
+IndexRule::IndexRule(std::span<Rule* const> rules) {
     for (Rule *rule : rules) {
         RuleParser::create(rule, *this)
             .expectMinNumArguments(1)
@@ -19,7 +19,7 @@ bool IndexRule::isSet() const {
 }
 
 /// @brief Get the list of index files defined by this rule.
-const std::vector<std::string>& IndexRule::getIndexFiles() const {
+const std::vector<InternedString>& IndexRule::getIndexFiles() const {
     return _indexFiles;
 }
 
@@ -6,11 +6,12 @@
 
 #include <ostream>
 #include <vector>
+#include <span>
 #include <string>
 
 class IndexRule : public BaseRule {
 private:
-    std::vector<std::string> _indexFiles;
+    std::vector<InternedString> _indexFiles;
 
 public:
     constexpr static Key getKey() { return Key::INDEX; }
@@ -19,13 +20,15 @@ public:
 
     IndexRule(const IndexRule &other) = default;
     IndexRule& operator=(const IndexRule &other) = default;
+    IndexRule(IndexRule &&other) = default;
+    IndexRule& operator=(IndexRule &&other) = default;
     ~IndexRule() = default;
     
     IndexRule() = default;
-    IndexRule(std::vector<Rule *> &rules);
+    IndexRule(std::span<Rule* const> rules);
 
     bool isSet() const;
-    const std::vector<std::string>& getIndexFiles() const;
+    const std::vector<InternedString>& getIndexFiles() const;
 };
 
 std::ostream& operator<<(std::ostream &os, const IndexRule &rule);
\ No newline at end of file
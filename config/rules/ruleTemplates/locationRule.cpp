@@ -1,3 +1,4 @@
+#include "../../types/regexAutomaton.hpp"
 #include "../../types/customTypes.hpp"
 #include "../objectParser.hpp"
 #include "../ruleParser.hpp"
@@ -9,22 +10,39 @@
 LocationRule::LocationRule(Object *object) {
     _isSet = true;
     path = Path::createDummy();
+    modifier = LocationModifier::PREFIX_MATCH;
 
     _parseFromObject(object);
 }
 
 LocationRule::LocationRule(Rule *rule) {
     _isSet = true;
-    Object *object;
+    modifier = LocationModifier::PREFIX_MATCH;
+    Object *object = nullptr;
 
-    RuleParser::create(rule, *this)
-        .expectArgumentCount(2)
-        .parseArgument(path)
+    RuleParser parser = RuleParser::create(rule, *this);
+    parser.expectArgumentCount(2, 3);
+    if (rule->arguments.size() == 3)
+        parser.parseArgument(modifier);
+    parser.parseArgument(path)
         .parseArgument(object);
 
+    if (!parser.failed() && modifier == LocationModifier::REGEX_MATCH)
+        _validateRegex(rule->arguments[rule->arguments.size() - 2]);
+
     _parseFromObject(object);
 }
 
+/// @brief Check if the path of a regex location compiles, so errors are reported at parse time instead of when building the router.
+/// @param argument The argument holding the regular expression, used for error reporting.
+void LocationRule::_validateRegex(const Argument *argument) const {
+    std::string error;
+
+    if (!RegexAutomaton::validate(path.str(), error))
+        DiagnosticSink::report<ParserArgumentException>(DiagnosticSink::of(argument->token), "Invalid regular expression in location", argument,
+            "Check the syntax of the regular expression (ECMAScript, without back references and lookarounds): " + error);
+}
+
 /// @brief Parse the location rule from an Object instance
 /// @param object The Object instance containing the rules to be parsed
 void LocationRule::_parseFromObject(Object *object) {
@@ -33,15 +51,27 @@ void LocationRule::_parseFromObject(Object *object) {
     objectParser.bound(Key::SERVER).optional()
         .parseFromRange(methods)
         .parseFromOne(root)
-        .parseFromOne(uploadStore)
-        .parseFromOne(autoIndex)
-        .parseFromRange(index)
+        .parseFromOne(_cold->uploadStore)
+        .parseFromOne(_cold->autoIndex)
+        .parseFromRange(_cold->index)
         .parseFromOne(returnRule)
-        .parseFromRange(errorPages)
-        .parseFromOne(maxBodySize)
+        .parseFromRange(_cold->errorPages)
+        .parseFromOne(_cold->errorPageCache)
+        .parseFromOne(_cold->maxBodySize)
         .parseFromOne(cgi)
-        .parseFromOne(cgiTimeout)
-        .parseFromRange(cgiExtention);
+        .parseFromOne(_cold->cgiTimeout)
+        .parseFromRange(_cold->cgiExtention);
+
+    _precomputeMapping();
+}
+
+/// @brief Precompute the parts of the URL to path mapping that only depend on the location,
+/// so mapping a request does not have to inspect the root and location path again.
+void LocationRule::_precomputeMapping() {
+    _urlPrefixLength = (modifier == LocationModifier::REGEX_MATCH) ? 0 : path.str().length();
+
+    const std::string &rootPath = root.getRootPath().str();
+    _mappedRootLength = rootPath.find_last_not_of('/') + 1;
 }
 
 /// @brief Check if the location rule is set (i.e., if it has a non-empty path).
@@ -49,19 +79,57 @@ bool LocationRule::isSet() const {
     return _isSet;
 }
 
+/// @brief Get the number of characters of the URL that are replaced by the root when mapping it to a path.
+size_t LocationRule::getUrlPrefixLength() const {
+    return _urlPrefixLength;
+}
+
+/// @brief Get the root path used for mapping URLs, without trailing slashes.
+std::string_view LocationRule::getMappedRoot() const {
+    return std::string_view(root.getRootPath().str()).substr(0, _mappedRootLength);
+}
+
+/// @brief Build the routing data of this location.
+/// @param locationIndex The index of this location in the location table of its server.
+LocationRoute LocationRule::getRoute(uint32_t locationIndex) const {
+    return (LocationRoute{
+        .prefix = path.str(),
+        .root = getMappedRoot(),
+        .returnParameter = returnRule.getParameter(),
+        .methods = methods.getMethods(),
+        .returnCode = returnRule.isSet() ? returnRule.getStatusCode().value : 0,
+        .modifier = modifier,
+        .cgiEnabled = cgi.isEnabled(),
+        .locationIndex = locationIndex,
+    });
+}
+
+/// @brief Get the rules that are only needed once a request has been routed to this location.
+LocationColdRules &LocationRule::cold() {
+    return (*_cold);
+}
+
+const LocationColdRules &LocationRule::cold() const {
+    return (*_cold);
+}
+
 std::ostream& operator<<(std::ostream &os, const LocationRule &rule) {
     os << "LocationRule: ";
-    os << "(" << rule.path.str() << ")\n";
+    os << "(";
+    if (rule.modifier != LocationModifier::PREFIX_MATCH)
+        os << rule.modifier << " ";
+    os << rule.path.str() << ")\n";
     os << rule.methods << "\n";
     os << rule.root << "\n";
-    os << rule.uploadStore << "\n";
-    os << rule.autoIndex << "\n";
-    os << rule.index << "\n";
+    os << rule.cold().uploadStore << "\n";
+    os << rule.cold().autoIndex << "\n";
+    os << rule.cold().index << "\n";
     os << rule.returnRule << "\n";
-    os << rule.errorPages << "\n";
-    os << rule.maxBodySize << "\n";
+    os << rule.cold().errorPages << "\n";
+    os << rule.cold().errorPageCache << "\n";
+    os << rule.cold().maxBodySize << "\n";
     os << rule.cgi << "\n";
-    os << rule.cgiTimeout << "\n";
-    os << rule.cgiExtention;
+    os << rule.cold().cgiTimeout << "\n";
+    os << rule.cold().cgiExtention;
     return os;
 }
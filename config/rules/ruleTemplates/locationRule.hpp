@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../types/customTypes.hpp"
+#include "../../types/consts.hpp"
 #include "../../config.hpp"
 #include "../baserule.hpp"
 
@@ -11,40 +12,75 @@
 #include "indexRule.hpp"
 #include "returnRule.hpp"
 #include "errorpageRule.hpp"
+#include "errorpageCacheRule.hpp"
 #include "maxBodySizeRule.hpp"
 #include "cgiRule.hpp"
 #include "cgiTimeoutRule.hpp"
 #include "cgiExtensionRule.hpp"
 
+#include <string_view>
+#include <cstdint>
 #include <ostream>
+#include <memory>
 #include <string>
 
+/// @brief The part of a location that is needed to route every request, kept small so the router can scan
+/// the routes of a server in one contiguous array. Everything else stays in the LocationRule and its LocationColdRules.
+/// @note The strings point into interned storage, so they stay valid for as long as any copy of the location exists.
+struct LocationRoute {
+    /// The location index of the default location, which is not part of the location table.
+    constexpr static uint32_t DEFAULT_LOCATION = UINT32_MAX;
+
+    std::string_view prefix;
+    std::string_view root;
+    std::string_view returnParameter;
+    Method methods;
+    int returnCode;
+    LocationModifier modifier;
+    bool cgiEnabled;
+    uint32_t locationIndex;
+};
+
+/// @brief The rules of a location that are only read once a request has been routed to it (the cold data).
+/// They live in their own allocation, so a LocationRule only holds what is needed to route and map a request.
+struct LocationColdRules {
+    UploadStoreRule uploadStore;
+    AutoIndexRule autoIndex;
+    IndexRule index;
+    ErrorPageRule errorPages;
+    ErrorPageCacheRule errorPageCache;
+    MaxBodySizeRule maxBodySize;
+    CgiTimeoutRule cgiTimeout;
+    CgiExtensionRule cgiExtention;
+};
+
 class LocationRule : public BaseRule {
 private:
     bool _isSet = false;
+    size_t _urlPrefixLength = 0;
+    size_t _mappedRootLength = 0;
+    std::unique_ptr<LocationColdRules> _cold = std::make_unique<LocationColdRules>();
 
     void _parseFromObject(Object *object);
+    void _precomputeMapping();
+    void _validateRegex(const Argument *argument) const;
 
 public:
     Path path;
+    LocationModifier modifier = LocationModifier::PREFIX_MATCH;
     MethodsRule methods;
     RootRule root;
-    UploadStoreRule uploadStore;
-    AutoIndexRule autoIndex;
-    IndexRule index;
     ReturnRule returnRule;
-    ErrorPageRule errorPages;
-    MaxBodySizeRule maxBodySize;
     CgiRule cgi;
-    CgiTimeoutRule cgiTimeout;
-    CgiExtensionRule cgiExtention;
 
     constexpr static Key getKey() { return Key::LOCATION; }
     constexpr static const std::string getRuleName() { return "location"; }
-    constexpr static const std::string getRuleFormat() { return LocationRule::getRuleName() + " <path> { ... }"; }
+    constexpr static const std::string getRuleFormat() { return LocationRule::getRuleName() + " [= | ~] <path> { ... }"; }
 
-    LocationRule(const LocationRule &other) = default;
-    LocationRule& operator=(const LocationRule &other) = default;
+    LocationRule(const LocationRule &other) = delete;
+    LocationRule& operator=(const LocationRule &other) = delete;
+    LocationRule(LocationRule &&other) = default;
+    LocationRule& operator=(LocationRule &&other) = default;
     ~LocationRule() = default;
 
     LocationRule() = default;
@@ -52,6 +88,11 @@ public:
     LocationRule(Object *object);
 
     bool isSet() const;
+    size_t getUrlPrefixLength() const;
+    std::string_view getMappedRoot() const;
+    LocationRoute getRoute(uint32_t locationIndex) const;
+    LocationColdRules &cold();
+    const LocationColdRules &cold() const;
 };
 
 std::ostream& operator<<(std::ostream &os, const LocationRule &rule);
\ No newline at end of file
@@ -18,6 +18,8 @@ public:
 
     MaxBodySizeRule(const MaxBodySizeRule &other) = default;
     MaxBodySizeRule& operator=(const MaxBodySizeRule &other) = default;
+    MaxBodySizeRule(MaxBodySizeRule &&other) = default;
+    MaxBodySizeRule& operator=(MaxBodySizeRule &&other) = default;
     ~MaxBodySizeRule() = default;
 
     MaxBodySizeRule();
@@ -8,7 +8,7 @@
 MethodsRule::MethodsRule() :
     _isSet(false), _methods(ALLOWED_METHODS_DEFAULT) {}
 
-MethodsRule::MethodsRule(const std::vector<Rule *> &rules) :
+MethodsRule::MethodsRule(std::span<Rule* const> rules) :
     _isSet(false), _methods(Method::UNKNOWN_METHOD)
 {
     for (Rule *rule : rules) {
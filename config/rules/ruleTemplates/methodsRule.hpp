@@ -7,6 +7,7 @@
 
 #include <ostream>
 #include <string>
+#include <span>
 
 #define ALLOWED_METHODS_DEFAULT (GET)
 
@@ -22,10 +23,12 @@ public:
 
     MethodsRule(const MethodsRule &other) = default;
     MethodsRule& operator=(const MethodsRule &other) = default;
+    MethodsRule(MethodsRule &&other) = default;
+    MethodsRule& operator=(MethodsRule &&other) = default;
     ~MethodsRule() = default;
 
     MethodsRule();
-    MethodsRule(const std::vector<Rule *> &rules);
+    MethodsRule(std::span<Rule* const> rules);
 
     bool isAllowed(Method method) const;
     Method getMethods() const;
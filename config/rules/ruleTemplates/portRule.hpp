@@ -20,6 +20,8 @@ public:
 
     PortRule(const PortRule &other) = default;
     PortRule& operator=(const PortRule &other) = default;
+    PortRule(PortRule &&other) = default;
+    PortRule& operator=(PortRule &&other) = default;
     ~PortRule() = default;
 
     PortRule();
@@ -5,10 +5,10 @@
 #include <ostream>
 
 ReturnRule::ReturnRule() :
-    _isSet(false), _statusCode(StatusCode::Wildcard()), _parameter("") {}
+    _isSet(false), _statusCode(StatusCode::Wildcard()), _parameter() {}
 
 ReturnRule::ReturnRule(Rule *rule) :
-    _isSet(false), _statusCode(StatusCode::Wildcard()), _parameter("") {
+    _isSet(false), _statusCode(StatusCode::Wildcard()), _parameter() {
     if (!rule) return;
 
     RuleParser::create(rule, *this)
@@ -36,7 +36,7 @@ const StatusCode ReturnRule::getStatusCode() const {
 
 /// @brief Get the optional parameter specified in the return rule.
 const std::string& ReturnRule::getParameter() const {
-    return _parameter;
+    return _parameter.str();
 }
 
 std::ostream& operator<<(std::ostream &os, const ReturnRule &rule) {
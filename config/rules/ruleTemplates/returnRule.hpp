@@ -11,7 +11,7 @@ class ReturnRule : public BaseRule {
 private:
     bool _isSet;
     StatusCode _statusCode;
-    std::string _parameter;
+    InternedString _parameter;
 
 public:
     constexpr static Key getKey() { return Key::RETURN; }
@@ -20,6 +20,8 @@ public:
 
     ReturnRule(const ReturnRule &other) = default;
     ReturnRule& operator=(const ReturnRule &other) = default;
+    ReturnRule(ReturnRule &&other) = default;
+    ReturnRule& operator=(ReturnRule &&other) = default;
     ~ReturnRule() = default;
 
     ReturnRule();
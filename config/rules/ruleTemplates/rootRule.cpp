@@ -14,9 +14,9 @@ RootRule::RootRule(Rule *rule) :
         .parseArgument(_rootPath);
 }
 
-/// @brief Check if the root rule is set (i.e., if it has a non-empty root path).
+/// @brief Check if the root rule is set (i.e., if it has a root path).
 bool RootRule::isSet() const {
-    return (!_rootPath.isValid());
+    return (_rootPath.isSet());
 }
 
 /// @brief Get the root path specified in the rule.
@@ -19,6 +19,8 @@ public:
     RootRule() = default;
     RootRule(const RootRule &other) = default;
     RootRule& operator=(const RootRule &other) = default;
+    RootRule(RootRule &&other) = default;
+    RootRule& operator=(RootRule &&other) = default;
     ~RootRule() = default;
 
     RootRule(Rule *rule);
@@ -3,8 +3,13 @@
 #include "../ruleParser.hpp"
 #include "../rules.hpp"
 
+#include <algorithm>
+
+ServerConfig::ServerConfig() :
+    _defaultRoute(_defaultLocation.getRoute(LocationRoute::DEFAULT_LOCATION)) {}
+
 ServerConfig::ServerConfig(Rule *rule) {
-    Object *object;
+    Object *object = nullptr;
 
     RuleParser::create(rule, *this)
         .expectArgumentCount(1)
@@ -18,6 +23,90 @@ ServerConfig::ServerConfig(Rule *rule) {
         .parseRange(_locations);
 
     _defaultLocation = LocationRule(object);
+    // An invalid server is discarded, so the router is only built for valid ones.
+    if (objectParser.failed())
+        return ;
+    _compileRouter(rule);
+    _preloadErrorPages(rule);
+}
+
+/// @brief Find the argument of the error_page rule in an object (or a nested location) that sets a page.
+/// @return The argument, or nullptr if no error_page rule sets the page.
+static const Argument *findErrorPageArgument(const Object *object, const std::string &page) {
+    for (const auto &[key, rules] : object->rules) {
+        for (const Rule *rule : rules) {
+            if (key == Key::ERROR_PAGE && !rule->arguments.empty() && rule->arguments.back()->token
+                && rule->arguments.back()->token->value == page)
+                return (rule->arguments.back());
+            for (const Argument *argument : rule->arguments)
+                if (argument->object)
+                    if (const Argument *found = findErrorPageArgument(argument->object, page))
+                        return (found);
+        }
+    }
+    return (nullptr);
+}
+
+/// @brief Preload the error responses of every location that has the error page cache enabled.
+/// A page that cannot be read is reported at the error_page rule that sets it (once, however many locations use it).
+void ServerConfig::_preloadErrorPages(Rule *rule) {
+    ErrorResponseCache cache;
+
+    for (LocationRule &location : _locations)
+        if (location.cold().errorPageCache.isEnabled())
+            location.cold().errorPages.preload(cache);
+    if (_defaultLocation.cold().errorPageCache.isEnabled())
+        _defaultLocation.cold().errorPages.preload(cache);
+
+    for (const std::string &page : cache.getUnreadablePages()) {
+        std::string hint = "The error page cache is on, so the page is read when the configuration is loaded - check that '"
+            + page + "' exists and is readable.";
+        const Argument *argument = findErrorPageArgument(rule->arguments[0]->object, page);
+        if (argument)
+            DiagnosticSink::report<ParserArgumentException>(DiagnosticSink::of(argument->token), "Failed to read error page", argument, hint);
+        else
+            DiagnosticSink::report<ParserRuleException>(DiagnosticSink::of(rule->token), "Failed to read error page " + page, rule, hint);
+    }
+}
+
+/// @brief Build the lookup structures for the locations.
+/// Every location gets a compact route, stored at the same index as the location itself. Exact locations
+/// are also stored in a hash table, while all regex locations are compiled into one automaton that matches
+/// them all in a single pass over the URL. The first regex location (in declaration order) that matches
+/// anywhere in the URL wins - like nginx. The prefix routes get their own array, sorted so that the first
+/// prefix that matches is the longest one.
+/// @param rule The server rule, used to report a location that cannot be compiled.
+void ServerConfig::_compileRouter(Rule *rule) {
+    std::string error;
+
+    _routes.reserve(_locations.size());
+    for (size_t i = 0; i < _locations.size(); ++i) {
+        _routes.push_back(_locations[i].getRoute(static_cast<uint32_t>(i)));
+        if (_locations[i].modifier == LocationModifier::PREFIX_MATCH)
+            _prefixRoutes.push_back(_routes.back());
+    }
+    std::stable_sort(_prefixRoutes.begin(), _prefixRoutes.end(), [](const LocationRoute &a, const LocationRoute &b) {
+        return (a.prefix.length() > b.prefix.length());
+    });
+    _defaultRoute = _defaultLocation.getRoute(LocationRoute::DEFAULT_LOCATION);
+
+    for (size_t i = 0; i < _locations.size(); ++i) {
+        const LocationRule &location = _locations[i];
+
+        if (location.modifier == LocationModifier::EXACT_MATCH)
+            _exactLocations.emplace(location.path.str(), i);
+
+        else if (location.modifier == LocationModifier::REGEX_MATCH) {
+            // The pattern was validated when the location was parsed, and compiles the same way into the shared automaton -
+            // a failure here is a bug, which must not silently route the location's requests elsewhere.
+            if (!_regexRouter.add(location.path.str(), error)) {
+                DiagnosticSink::report<ParserRuleException>(DiagnosticSink::of(rule->token),
+                    "Internal error: the regex location '" + location.path.str() + "' passed validation but cannot be compiled: " + error, rule);
+                return ;
+            }
+            _regexLocations.push_back(i);
+        }
+    }
 }
 
 /// @brief Check if the server configuration rule is set (i.e., if it contains any locations).
@@ -35,24 +124,41 @@ const LocationRule& ServerConfig::getDefaultLocation() const {
     return _defaultLocation;
 }
 
-/// @brief Get the location rule for a specific URL.
-/// @param url The URL for which the location rule is requested.
-/// @return The location rule that matches the given URL, or the default location if no specific match is found.
-const LocationRule& ServerConfig::getLocation(const std::string &url) const {
-    const LocationRule *bestMatch = &_defaultLocation;
-    size_t longestMatch = 0;
+/// @brief Get the route (the data needed to handle a request) for a specific path.
+/// The lookup order is: exact locations, then the first matching regex location and finally the longest matching prefix location.
+/// Only the compact route tables are scanned, the location rules themselves are not touched.
+/// @param uri The normalized path of the request (see Path::normalizeUrl) - the same path that is then mapped with
+/// Path::createFromPath, so that a URL like "//static/../x" or "/%73tatic/x" cannot bypass the rules of a location.
+/// @return The route of the location that matches the given path, or the route of the default location.
+const LocationRoute& ServerConfig::getRoute(std::string_view uri) const {
+    auto exactIt = _exactLocations.find(uri);
+    if (exactIt != _exactLocations.end())
+        return (_routes[exactIt->second]);
 
-    for (const LocationRule &location : _locations) {
-        if (!location.isSet())
-            continue;
-
-        if (location.path.str().length() > longestMatch && url.starts_with(location.path.str())) {
-            longestMatch = location.path.str().length();
-            bestMatch = &location;
-        }
+    if (!_regexRouter.empty()) {
+        uint32_t match = _regexRouter.firstMatch(uri);
+        if (match != RegexAutomaton::NO_MATCH)
+            return (_routes[_regexLocations[match]]);
     }
 
-    return (*bestMatch);
+    for (const LocationRoute &route : _prefixRoutes)
+        if (uri.starts_with(route.prefix))
+            return (route);
+    return (_defaultRoute);
+}
+
+/// @brief Get the location rule for a specific path.
+/// @param uri The normalized path of the request (see Path::normalizeUrl).
+/// @return The location rule that matches the given path, or the default location if no specific match is found.
+const LocationRule& ServerConfig::getLocation(std::string_view uri) const {
+    return (getLocation(getRoute(uri)));
+}
+
+/// @brief Get the full location rule of a route, for the data that is not part of the route itself.
+const LocationRule& ServerConfig::getLocation(const LocationRoute &route) const {
+    if (route.locationIndex >= _locations.size())
+        return (_defaultLocation);
+    return (_locations[route.locationIndex]);
 }
 
 std::ostream& operator<<(std::ostream &os, const ServerConfig &rule) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../../types/regexAutomaton.hpp"
 #include "../../types/customTypes.hpp"
 #include "servernameRule.hpp"
 #include "locationRule.hpp"
@@ -7,13 +8,38 @@
 #include "../baserule.hpp"
 #include "portRule.hpp"
 
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <string>
 
+/// @brief Transparent hash, so the exact-match table can be queried with a std::string_view.
+struct LocationPathHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+};
+
+/// @brief A server block, built once from the parsed configuration.
+/// @note A built ServerConfig is immutable: every const method (route and location lookups, error pages, CGI matching)
+/// only reads, so any number of threads may use one configuration at the same time without locking. Everything that is
+/// shared between copies of rules (interned strings, error page tables, preloaded responses) is immutable and reference-counted,
+/// so copying a rule while other threads read it is safe as well. See `parser --stress=N` to exercise this.
 class ServerConfig : public BaseRule {
 private:
     std::vector<LocationRule> _locations;
     LocationRule _defaultLocation;
 
+    std::vector<LocationRoute> _routes;
+    /// The routes of the prefix locations, longest prefix first (and in declaration order for prefixes of the same length).
+    std::vector<LocationRoute> _prefixRoutes;
+    LocationRoute _defaultRoute;
+
+    std::unordered_map<std::string, size_t, LocationPathHash, std::equal_to<>> _exactLocations;
+    std::vector<size_t> _regexLocations;
+    RegexAutomaton _regexRouter;
+
+    void _compileRouter(Rule *rule);
+    void _preloadErrorPages(Rule *rule);
 
 public:
     PortRule port;
@@ -23,13 +49,21 @@ public:
     constexpr static const std::string getRuleName() { return "server"; }
     constexpr static const std::string getRuleFormat() { return ServerConfig::getRuleName() + " { ... }"; }
 
-    ServerConfig() = default;
+    ServerConfig(const ServerConfig &other) = delete;
+    ServerConfig& operator=(const ServerConfig &other) = delete;
+    ServerConfig(ServerConfig &&other) = default;
+    ServerConfig& operator=(ServerConfig &&other) = default;
+    ~ServerConfig() = default;
+
+    ServerConfig();
     ServerConfig(Rule *rule);
 
     bool isSet() const;
     const std::vector<LocationRule>& getLocations() const;
     const LocationRule& getDefaultLocation() const;
-    const LocationRule& getLocation(const std::string &url) const;
+    const LocationRule& getLocation(std::string_view uri) const;
+    const LocationRule& getLocation(const LocationRoute &route) const;
+    const LocationRoute& getRoute(std::string_view uri) const;
 };
 
 std::ostream& operator<<(std::ostream &os, const ServerConfig &rule);
@@ -6,10 +6,10 @@
 #include <string>
 
 ServerNameRule::ServerNameRule()
-    : _serverName("") {}
+    : _serverName() {}
 
 ServerNameRule::ServerNameRule(Rule *rule)
-    : _serverName("")
+    : _serverName()
 {
     if (!rule) return;
 
@@ -25,7 +25,7 @@ bool ServerNameRule::isSet() const {
 
 /// @brief Get the server name specified in the rule.
 const std::string& ServerNameRule::getServerName() const {
-    return _serverName;
+    return _serverName.str();
 }
 
 std::ostream& operator<<(std::ostream &os, const ServerNameRule &rule) {
@@ -9,7 +9,7 @@
 
 class ServerNameRule : public BaseRule {
 private:
-    std::string _serverName;
+    InternedString _serverName;
 
 public:
     constexpr static Key getKey() { return Key::SERVER_NAME; }
@@ -18,6 +18,8 @@ public:
 
     ServerNameRule(const ServerNameRule &other) = default;
     ServerNameRule& operator=(const ServerNameRule &other) = default;
+    ServerNameRule(ServerNameRule &&other) = default;
+    ServerNameRule& operator=(ServerNameRule &&other) = default;
     ~ServerNameRule() = default;
 
     ServerNameRule();
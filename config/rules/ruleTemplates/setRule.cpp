@@ -0,0 +1,55 @@
+#include "../../parserExceptions.hpp"
+#include "../../diagnostics.hpp"
+#include "../ruleParser.hpp"
+#include "setRule.hpp"
+#include "../rules.hpp"
+
+#include <ostream>
+#include <cctype>
+
+SetRule::SetRule(Rule *rule) {
+    RuleParser parser = RuleParser::create(rule, *this);
+    parser.expectArgumentCount(2)
+        .parseArgument(_name)
+        .parseArgument(_value);
+    if (parser.failed())
+        return ;
+
+    if (_name.size() < 2 || _name[0] != '$' || !isValidName(std::string_view(_name).substr(1))) {
+        DiagnosticSink::report<ParserArgumentException>(DiagnosticSink::of(rule->token), "Invalid variable name", rule->arguments[0],
+            "Variable names start with '$', followed by letters, digits or underscores (e.g. $web_root).");
+        _name.clear();
+        return ;
+    }
+    _name.erase(0, 1);
+}
+
+/// @brief Check if a name (without the leading '$') can be used as a variable name: a letter or underscore, followed by letters, digits or underscores.
+bool SetRule::isValidName(std::string_view name) {
+    if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0])))
+        return (false);
+    for (char c : name)
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_')
+            return (false);
+    return (true);
+}
+
+/// @brief Get the name of the variable, without the leading '$'.
+const std::string& SetRule::getName() const {
+    return _name;
+}
+
+/// @brief Get the value of the variable, with the variables it references already expanded.
+const InternedString& SetRule::getValue() const {
+    return _value;
+}
+
+/// @brief Check if the rule is set (i.e., if it has a valid name).
+bool SetRule::isSet() const {
+    return (!_name.empty());
+}
+
+std::ostream& operator<<(std::ostream &os, const SetRule &rule) {
+    os << "SetRule: $" << rule.getName() << " = " << rule.getValue();
+    return os;
+}
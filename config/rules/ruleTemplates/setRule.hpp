@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../../types/customTypes.hpp"
+#include "../../config.hpp"
+#include "../baserule.hpp"
+
+#include <ostream>
+#include <string>
+
+/// @brief Sets a variable for the rest of its block and every block nested in it: `set $name value;`.
+/// Variables are referenced as ${name} inside any string argument and are expanded while the configuration is parsed.
+class SetRule : public BaseRule {
+private:
+    std::string _name;
+    InternedString _value;
+
+public:
+    constexpr static Key getKey() { return Key::SET; }
+    constexpr static const std::string getRuleName() { return "set"; }
+    constexpr static const std::string getRuleFormat() { return SetRule::getRuleName() + " $<name> <value>"; }
+
+    SetRule(const SetRule &other) = default;
+    SetRule& operator=(const SetRule &other) = default;
+    SetRule(SetRule &&other) = default;
+    SetRule& operator=(SetRule &&other) = default;
+    ~SetRule() = default;
+
+    SetRule() = delete;
+    SetRule(Rule *rule);
+
+    static bool isValidName(std::string_view name);
+
+    const std::string& getName() const;
+    const InternedString& getValue() const;
+    bool isSet() const;
+};
+
+std::ostream& operator<<(std::ostream &os, const SetRule &rule);
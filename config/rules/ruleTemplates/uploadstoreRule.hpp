@@ -18,6 +18,8 @@ public:
 
     UploadStoreRule(const UploadStoreRule &other) = default;
     UploadStoreRule& operator=(const UploadStoreRule &other) = default;
+    UploadStoreRule(UploadStoreRule &&other) = default;
+    UploadStoreRule& operator=(UploadStoreRule &&other) = default;
     ~UploadStoreRule() = default;
 
     UploadStoreRule();
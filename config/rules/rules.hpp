@@ -5,6 +5,7 @@
 #include "ruleTemplates/cgiRule.hpp"
 #include "ruleTemplates/cgiTimeoutRule.hpp"
 #include "ruleTemplates/defineRule.hpp"
+#include "ruleTemplates/errorpageCacheRule.hpp"
 #include "ruleTemplates/errorpageRule.hpp"
 #include "ruleTemplates/includeRule.hpp"
 #include "ruleTemplates/indexRule.hpp"
@@ -14,6 +15,7 @@
 #include "ruleTemplates/returnRule.hpp"
 #include "ruleTemplates/rootRule.hpp"
 #include "ruleTemplates/servernameRule.hpp"
+#include "ruleTemplates/setRule.hpp"
 #include "ruleTemplates/uploadstoreRule.hpp"
 
 #include "ruleTemplates/locationRule.hpp"
@@ -0,0 +1,45 @@
+#include "sourceCache.hpp"
+
+#include <filesystem>
+#include <iterator>
+#include <fstream>
+
+/// @brief Read a file and compute its fingerprint.
+/// @return The file, or nullptr if it cannot be opened.
+std::shared_ptr<const SourceFile> SourceFile::read(const std::string &filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+        return (nullptr);
+
+    std::shared_ptr<SourceFile> source = std::make_shared<SourceFile>();
+    source->content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    std::error_code error;
+    auto modifiedTime = std::filesystem::last_write_time(filePath, error);
+    int64_t modifiedTimeCount = error ? 0 : modifiedTime.time_since_epoch().count();
+    source->fingerprint = {true, source->content.size(), modifiedTimeCount, FileFingerprint::hashContent(source->content)};
+    return (source);
+}
+
+/// @brief Get a file from the cache, reading it on first use.
+/// The file is read without holding the lock - when two parsers ask for the same new file, both read it and the first one is kept.
+/// @return The file, or nullptr if it cannot be opened.
+std::shared_ptr<const SourceFile> SourceCache::load(const std::string &filePath) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _files.find(filePath);
+        if (it != _files.end())
+            return (it->second);
+    }
+
+    std::shared_ptr<const SourceFile> source = SourceFile::read(filePath);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (_files.emplace(filePath, std::move(source)).first->second);
+}
+
+/// @brief Get the number of cached files.
+size_t SourceCache::size() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (_files.size());
+}
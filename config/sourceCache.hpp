@@ -0,0 +1,35 @@
+#pragma once
+
+#include "config.hpp"
+
+#include <memory>
+#include <string>
+#include <mutex>
+#include <map>
+
+/// @brief The content of a configuration file, as it was read from disk.
+struct SourceFile {
+    std::string content;
+    FileFingerprint fingerprint;
+
+    static std::shared_ptr<const SourceFile> read(const std::string &filePath);
+};
+
+/// @brief Shares the files of a configuration between parsers that run at the same time, so a file that is
+/// included by many configurations is only read once. A file is never read again once it is cached -
+/// the cache is a consistent view of the files for as long as it lives.
+/// @note The cache is thread-safe. Files that cannot be read are cached as well.
+class SourceCache {
+private:
+    std::mutex _mutex;
+    std::map<std::string, std::shared_ptr<const SourceFile>> _files;
+
+public:
+    SourceCache() = default;
+    SourceCache(const SourceCache&) = delete;
+    SourceCache& operator=(const SourceCache&) = delete;
+    ~SourceCache() = default;
+
+    std::shared_ptr<const SourceFile> load(const std::string &filePath);
+    size_t size();
+};
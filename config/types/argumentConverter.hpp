@@ -1,13 +1,32 @@
 #pragma once
 
 #include "../parserExceptions.hpp"
+#include "../diagnostics.hpp"
 #include "customTypes.hpp"
 #include "../../print.hpp"
 #include "consts.hpp"
 
+#include <string_view>
 #include <limits>
 #include <string>
 
+/// @brief Intern a string in the pool of the file the argument comes from.
+inline InternedString internArgumentString(const Argument *arg, std::string_view str) {
+    StringPool *pool = (arg->token && arg->token->configFile) ? arg->token->configFile->stringPool : nullptr;
+
+    if (!pool)
+        return (InternedString(std::string(str)));
+    return (pool->intern(str));
+}
+
+/// @brief Report an invalid argument to the diagnostic sink of its file, or throw it if the file has no sink.
+/// @param fallback The value the conversion returns after reporting the error.
+template <typename T>
+T invalidArgument(const Argument *arg, const std::string &message, const std::string &hint, T fallback = T()) {
+    DiagnosticSink::report<ParserArgumentException>(DiagnosticSink::of(arg->token), message, arg, hint);
+    return (fallback);
+}
+
 template <typename To, typename From>
 struct ArgumentConverter {
     static To convert(const From& from) {
@@ -19,91 +38,94 @@ struct ArgumentConverter {
 template <>
 struct ArgumentConverter<int, Argument*> {
     static int convert(const Argument* arg) {
-        try {
-            return (std::stoi(std::get<std::string>(arg->value)));
-        } catch (...) {
-            throw ParserArgumentException("Expected an integer", arg, \
-                "Check the argument type. Expected an integer, but found: " + arg->token->value);
-        }
+        Converted<int> result = parseInteger<int>(arg->getString());
+        if (!result)
+            return (invalidArgument<int>(arg, "Expected an integer", \
+                "Check the argument type. Expected an integer, but found: " + arg->token->value + " (" + getConversionErrorReason(result.error) + ")"));
+        return (result.value);
     }
 };
 
 template <>
 struct ArgumentConverter<PortNumber, Argument*> {
     static PortNumber convert(const Argument* arg) {
-        try {
-            return (PortNumber(std::stoi(std::get<std::string>(arg->value))));
-        } catch (...) {
-            throw ParserArgumentException("Expected an unsigned 16-bit integer", arg, \
-                "Check the argument type. Expected an unsigned 16-bit integer, but found: " + arg->token->value);
-        }
+        Converted<PortNumber> result = PortNumber::parse(arg->getString());
+        if (!result)
+            return (invalidArgument<PortNumber>(arg, "Expected an unsigned 16-bit integer", \
+                "Check the argument type. Expected an unsigned 16-bit integer, but found: " + arg->token->value + " (" + getConversionErrorReason(result.error) + ")", PortNumber(0)));
+        return (result.value);
     }
 };
 
 template <>
 struct ArgumentConverter<StatusCode, Argument*> {
     static StatusCode convert(const Argument* arg) {
-        try {
-            std::string value = std::get<std::string>(arg->value);
-            if (value == "*")
-                return StatusCode::Wildcard();
-            return (StatusCode(std::stoi(value)));
-        } catch (...) {
-            throw ParserArgumentException("Expected a valid error code", arg, \
-                "Check the argument type. Expected a valid error code {100 <= code <= 599}, but found: " + arg->token->value);
-        }
+        Converted<StatusCode> result = StatusCode::parse(arg->getString());
+        if (!result)
+            return (invalidArgument<StatusCode>(arg, "Expected a valid error code", \
+                "Check the argument type. Expected a valid error code {100 <= code <= 599}, but found: " + arg->token->value + " (" + getConversionErrorReason(result.error) + ")", StatusCode::Wildcard()));
+        return (result.value);
     }
 };
 
 template <>
 struct ArgumentConverter<std::string, Argument*> {
     static std::string convert(const Argument* arg) {
-        if (arg->type != ArgumentType::STRING)
-            throw ParserArgumentException("Expected a string", arg, \
-                "Check the argument type. Expected a string, but found: " + arg->token->value);
-        return std::get<std::string>(arg->value);
+        if (arg->getType() != ArgumentType::STRING)
+            return (invalidArgument<std::string>(arg, "Expected a string", \
+                "Check the argument type. Expected a string, but found: " + arg->token->value));
+        return arg->getString();
+    }
+};
+
+template <>
+struct ArgumentConverter<InternedString, Argument*> {
+    static InternedString convert(const Argument* arg) {
+        if (arg->getType() != ArgumentType::STRING)
+            return (invalidArgument<InternedString>(arg, "Expected a string", \
+                "Check the argument type. Expected a string, but found: " + arg->token->value));
+        return (internArgumentString(arg, arg->getString()));
     }
 };
 
 template <>
 struct ArgumentConverter<Object*, Argument*> {
     static Object* convert(const Argument* arg) {
-        if (arg->type != ArgumentType::OBJECT)
-            throw ParserArgumentException("Expected an object", arg, \
-                "Check the argument type. Expected an object, but found: " + arg->token ->value);
-        return std::get<Object*>(arg->value);
+        if (arg->getType() != ArgumentType::OBJECT)
+            return (invalidArgument<Object*>(arg, "Expected an object", \
+                "Check the argument type. Expected an object, but found: " + arg->token ->value));
+        return arg->getObject();
     }
 };
 
 template <>
 struct ArgumentConverter<Size, Argument*> {
     static Size convert(const Argument* arg) {
-        try {
-            return Size(std::get<std::string>(arg->value));
-        } catch (...) {
-            throw ParserArgumentException("Expected a valid size", arg, \
-                "Check the argument type. Expected a valid size {x (kb, mb, gb)}, but found: " + arg->token->value);
-        }
+        Converted<Size> result = Size::parse(arg->getString());
+        if (!result)
+            return (invalidArgument<Size>(arg, "Expected a valid size", \
+                "Check the argument type. Expected a valid size {x (kb, mb, gb)}, but found: " + arg->token->value + " (" + getConversionErrorReason(result.error) + ")"));
+        return (result.value);
     }
 };
 
 template <>
 struct ArgumentConverter<Path, Argument*> {
     static Path convert(const Argument* arg) {
-        if (arg->type != ArgumentType::STRING)
-            throw ParserArgumentException("Expected a path", arg, \
-                "Check the argument type. Expected a path, but found: " + arg->token->value);
-        return Path(std::get<std::string>(arg->value));
+        if (arg->getType() != ArgumentType::STRING)
+            return (invalidArgument<Path>(arg, "Expected a path", \
+                "Check the argument type. Expected a path, but found: " + arg->token->value));
+        return Path(internArgumentString(arg, arg->getString()));
     }
 };
 
 template <>
 struct ArgumentConverter<bool, Argument*> {
     static bool convert(const Argument* arg) {
-        if (arg->type != ArgumentType::KEYWORD)
-            throw ParserArgumentException("Expected a boolean keyword", arg, \
-                "Check the argument type. Expected a boolean keyword (on/off), but found: " + arg->token->value);
-        switch (std::get<Keyword>(arg->value)) {
+        if (arg->getType() != ArgumentType::KEYWORD)
+            return (invalidArgument<bool>(arg, "Expected a boolean keyword", \
+                "Check the argument type. Expected a boolean keyword (on/off), but found: " + arg->token->value));
+        switch (arg->getKeyword()) {
             case Keyword::ENABLE:
             case Keyword::TRUE:
             case Keyword::ON:
@@ -113,8 +135,8 @@ struct ArgumentConverter<bool, Argument*> {
             case Keyword::OFF:
                 return false;
             default:
-                throw ParserArgumentException("Expected a boolean keyword", arg, \
-                    "Check the argument type. Expected a boolean keyword (on/off), but found: " + arg->token->value);
+                return (invalidArgument<bool>(arg, "Expected a boolean keyword", \
+                    "Check the argument type. Expected a boolean keyword (on/off), but found: " + arg->token->value));
         }
     }
 };
@@ -122,27 +144,26 @@ struct ArgumentConverter<bool, Argument*> {
 template <>
 struct ArgumentConverter<Timespan, Argument*> {
     static Timespan convert(const Argument* arg) {
-        try {
-            return Timespan(std::get<std::string>(arg->value));
-        } catch (...) {
-            throw ParserArgumentException("Expected a valid time span", arg, \
-                "Check the argument type. Expected a valid time span in seconds, but found: " + arg->token->value);
-        }
+        Converted<Timespan> result = Timespan::parse(arg->getString());
+        if (!result)
+            return (invalidArgument<Timespan>(arg, "Expected a valid time span", \
+                "Check the argument type. Expected a valid time span in seconds, but found: " + arg->token->value + " (" + getConversionErrorReason(result.error) + ")"));
+        return (result.value);
     }
 };
 
 template <>
 struct ArgumentConverter<DefaultVal, Argument*> {
     static DefaultVal convert(const Argument* arg) {
-        if (arg->type != ArgumentType::KEYWORD)
-            throw ParserArgumentException("Expected a default value keyword", arg, \
-                "Check the argument type. Expected a default value keyword (default), but found: " + arg->token->value);
-        switch (std::get<Keyword>(arg->value)) {
+        if (arg->getType() != ArgumentType::KEYWORD)
+            return (invalidArgument<DefaultVal>(arg, "Expected a default value keyword", \
+                "Check the argument type. Expected a default value keyword (default), but found: " + arg->token->value, DefaultVal(false)));
+        switch (arg->getKeyword()) {
             case Keyword::DEFAULT:
                 return DefaultVal(true);
             default:
-                throw ParserArgumentException("Expected a default value keyword", arg, \
-                    "Check the argument type. Expected a default value keyword (default), but found: " + arg->token->value);
+                return (invalidArgument<DefaultVal>(arg, "Expected a default value keyword", \
+                    "Check the argument type. Expected a default value keyword (default), but found: " + arg->token->value, DefaultVal(false)));
         }
     }
 };
@@ -150,14 +171,52 @@ struct ArgumentConverter<DefaultVal, Argument*> {
 template <>
 struct ArgumentConverter<Method, Argument*> {
     static Method convert(const Argument* arg) {
-        if (arg->type != ArgumentType::STRING)
-            throw ParserArgumentException("Expected a method keyword", arg, \
-                "Check the argument type. Expected a method keyword (get/post/delete/put/head/options), but found: " + arg->token->value);
-        std::string methodStr = std::get<std::string>(arg->value);
+        if (arg->getType() != ArgumentType::STRING)
+            return (invalidArgument<Method>(arg, "Expected a method keyword", \
+                "Check the argument type. Expected a method keyword (get/post/delete/put/head/options), but found: " + arg->token->value, UNKNOWN_METHOD));
+        std::string methodStr = arg->getString();
         Method method = stringToMethod(methodStr);
         if (method == UNKNOWN_METHOD)
-            throw ParserArgumentException("Expected a method keyword", arg, \
-                "Check the argument type. Expected a method keyword (get/post/delete/put/head/options), but found: " + arg->token->value);
+            return (invalidArgument<Method>(arg, "Expected a method keyword", \
+                "Check the argument type. Expected a method keyword (get/post/delete/put/head/options), but found: " + arg->token->value, UNKNOWN_METHOD));
         return (method);
     }
 };
+
+template <>
+struct ArgumentConverter<LocationModifier, Argument*> {
+    static LocationModifier convert(const Argument* arg) {
+        if (arg->getType() != ArgumentType::STRING)
+            return (invalidArgument<LocationModifier>(arg, "Expected a location modifier", \
+                "Check the argument type. Expected a location modifier (= or ~), but found: " + arg->token->value, UNKNOWN_MODIFIER));
+        LocationModifier modifier = stringToLocationModifier(arg->getString());
+        if (modifier == UNKNOWN_MODIFIER)
+            return (invalidArgument<LocationModifier>(arg, "Expected a location modifier", \
+                "Check the argument type. Expected a location modifier (= or ~), but found: " + arg->token->value, UNKNOWN_MODIFIER));
+        return (modifier);
+    }
+};
+
+template <>
+struct ArgumentConverter<CgiExtension, Argument*> {
+    static CgiExtension convert(const Argument* arg) {
+        if (arg->getType() != ArgumentType::STRING)
+            return (invalidArgument<CgiExtension>(arg, "Expected a CGI extension", \
+                "Check the argument type. Expected a CGI extension (.ext or .ext=interpreter), but found: " + arg->token->value));
+
+        std::string_view value = arg->getString();
+        size_t separator = value.find('=');
+        size_t start = (!value.empty() && value[0] == '.') ? 1 : 0;
+
+        std::string_view extension = value.substr(start, separator == std::string::npos ? std::string::npos : separator - start);
+        std::string_view interpreter = (separator != std::string::npos) ? value.substr(separator + 1) : std::string_view();
+
+        if (extension.empty() || extension.find_first_of("./") != std::string::npos)
+            return (invalidArgument<CgiExtension>(arg, "Invalid CGI extension", \
+                "Expected a single file extension like .py, but found: " + arg->token->value));
+        if (separator != std::string::npos && interpreter.empty())
+            return (invalidArgument<CgiExtension>(arg, "Missing CGI interpreter", \
+                "Give the path of the interpreter after the '=', or remove the '=' to execute the script directly."));
+        return (CgiExtension{internArgumentString(arg, extension), internArgumentString(arg, interpreter)});
+    }
+};
@@ -2,6 +2,7 @@
 #include "../../print.hpp"
 
 #include <type_traits>
+#include <algorithm>
 #include <string>
 
 Method operator|(Method lhs, Method rhs) {
@@ -43,7 +44,28 @@ std::ostream& operator<<(std::ostream& os, const Method& method) {
 	return os;
 }
 
-std::string getStatusCodeAsStr(HttpStatusCode code) {
+LocationModifier stringToLocationModifier(const std::string &str) {
+	if (str == "=") return EXACT_MATCH;
+	if (str == "~") return REGEX_MATCH;
+	return UNKNOWN_MODIFIER;
+}
+
+std::string locationModifierToStr(LocationModifier modifier) {
+	switch (modifier) {
+		case PREFIX_MATCH: return "";
+		case EXACT_MATCH: return "=";
+		case REGEX_MATCH: return "~";
+		default: return "UNKNOWN";
+	}
+}
+
+std::ostream& operator<<(std::ostream& os, LocationModifier modifier) {
+	os << locationModifierToStr(modifier);
+	return os;
+}
+
+/// @brief Get the reason phrase of a status code, or nullptr if the status code is unknown.
+const char *getStatusCodeReason(HttpStatusCode code) {
     switch (code) {
         // 1xx
         case HttpStatusCode::Continue: return "Continue";
@@ -117,10 +139,18 @@ std::string getStatusCodeAsStr(HttpStatusCode code) {
         case HttpStatusCode::NotExtended: return "Not Extended";
         case HttpStatusCode::NetworkAuthenticationRequired: return "Network Authentication Required";
 
-        default:
-            ERROR("Unknown HTTP Status Code: " << static_cast<int>(code));
-            return "Unknown Status Code";
+        default: return nullptr;
+    }
+}
+
+std::string getStatusCodeAsStr(HttpStatusCode code) {
+    const char *reason = getStatusCodeReason(code);
+
+    if (!reason) {
+        ERROR("Unknown HTTP Status Code: " << static_cast<int>(code));
+        return "Unknown Status Code";
     }
+    return reason;
 }
 
 std::ostream& operator<<(std::ostream& os, HttpStatusCode code) {
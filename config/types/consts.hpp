@@ -20,6 +20,18 @@ std::string methodToStr(const Method &method);
 
 std::ostream &operator<<(std::ostream &os, const Method &method);
 
+enum LocationModifier {
+	UNKNOWN_MODIFIER = 0,
+	PREFIX_MATCH = 1 << 0,
+	EXACT_MATCH = 1 << 1,
+	REGEX_MATCH = 1 << 2,
+};
+
+LocationModifier stringToLocationModifier(const std::string &str);
+std::string locationModifierToStr(LocationModifier modifier);
+
+std::ostream &operator<<(std::ostream &os, LocationModifier modifier);
+
 enum class HttpStatusCode {
     // 1xx
     Continue = 100,
@@ -94,6 +106,7 @@ enum class HttpStatusCode {
     NetworkAuthenticationRequired = 511
 };
 
+const char *getStatusCodeReason(HttpStatusCode code);
 std::string getStatusCodeAsStr(HttpStatusCode code);
 std::ostream &operator<<(std::ostream &os, HttpStatusCode code);
 
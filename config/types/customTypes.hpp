@@ -1,11 +1,125 @@
 #pragma once
 
+#include <unordered_set>
+#include <string_view>
+#include <charconv>
 #include <ostream>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <string>
+#include <span>
+#include <stdexcept>
 
 class LocationRule;
+class StringPool;
+
+/// @brief An immutable string that shares its storage with every other copy of it. Strings interned
+/// through the same StringPool share one allocation, so equal strings can be compared by pointer.
+class InternedString {
+private:
+	std::shared_ptr<const std::string> _str;
+
+	friend class StringPool;
+	explicit InternedString(std::shared_ptr<const std::string> str);
+
+public:
+	InternedString() = default;
+	explicit InternedString(std::string str);
+	InternedString(const InternedString &other) = default;
+	InternedString &operator=(const InternedString &other) = default;
+	InternedString(InternedString &&other) = default;
+	InternedString &operator=(InternedString &&other) = default;
+	~InternedString() = default;
+
+	const std::string &str() const;
+	const char *data() const;
+	size_t length() const;
+	bool empty() const;
+
+	operator const std::string&() const { return (str()); }
+	bool operator==(const InternedString &other) const;
+};
+
+/// @brief Stores every distinct string of a configuration once. The pool only needs to outlive the parsing:
+/// the interned strings keep their storage alive themselves.
+class StringPool {
+private:
+	struct Hash {
+		using is_transparent = void;
+		size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+		size_t operator()(const std::shared_ptr<const std::string> &str) const { return (*this)(std::string_view(*str)); }
+	};
+
+	struct Equal {
+		using is_transparent = void;
+		static std::string_view view(std::string_view str) { return str; }
+		static std::string_view view(const std::shared_ptr<const std::string> &str) { return *str; }
+		template <typename A, typename B>
+		bool operator()(const A &lhs, const B &rhs) const { return view(lhs) == view(rhs); }
+	};
+
+	std::unordered_set<std::shared_ptr<const std::string>, Hash, Equal> _strings;
+
+public:
+	StringPool() = default;
+	StringPool(const StringPool&) = delete;
+	StringPool& operator=(const StringPool&) = delete;
+	~StringPool() = default;
+
+	InternedString intern(std::string_view str);
+	size_t size() const;
+};
+
+/// @brief The reason a string could not be converted to a value.
+enum class ConversionError {
+    NONE = 0,
+    EMPTY,
+    NOT_A_NUMBER,
+    OUT_OF_RANGE,
+    INVALID_UNIT,
+    TRAILING_CHARACTERS,
+};
+
+constexpr const char *getConversionErrorReason(ConversionError error) {
+    switch (error) {
+        case ConversionError::NONE: return "no error";
+        case ConversionError::EMPTY: return "the value is empty";
+        case ConversionError::NOT_A_NUMBER: return "the value is not a number";
+        case ConversionError::OUT_OF_RANGE: return "the value is out of range";
+        case ConversionError::INVALID_UNIT: return "the unit is not supported";
+        case ConversionError::TRAILING_CHARACTERS: return "the value is followed by unexpected characters";
+    }
+    return "unknown error";
+}
+
+/// @brief The result of a conversion that does not throw: either the value, or the reason the conversion failed.
+template <typename T>
+struct Converted {
+    T value{};
+    ConversionError error = ConversionError::NONE;
+
+    static Converted failure(ConversionError reason) { return Converted{T{}, reason}; }
+    explicit operator bool() const { return (error == ConversionError::NONE); }
+};
+
+/// @brief Parse a whole string as an integer. Unlike std::stoi, whitespace, a leading '+' and trailing characters are rejected.
+/// @return The number, or the reason it could not be parsed.
+template <typename T>
+Converted<T> parseInteger(std::string_view str) {
+    T value{};
+
+    if (str.empty())
+        return Converted<T>::failure(ConversionError::EMPTY);
+    auto [end, errc] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (errc == std::errc::result_out_of_range)
+        return Converted<T>::failure(ConversionError::OUT_OF_RANGE);
+    if (errc != std::errc())
+        return Converted<T>::failure(ConversionError::NOT_A_NUMBER);
+    if (end != str.data() + str.size())
+        return Converted<T>::failure(ConversionError::TRAILING_CHARACTERS);
+    return Converted<T>{value};
+}
 
 struct StatusCode {
     int value;
@@ -19,6 +133,18 @@ struct StatusCode {
         return StatusCode(-1);
     }
 
+    /// @brief Parse a status code {100 <= code <= 599}, or '*' for any status code.
+    inline static Converted<StatusCode> parse(std::string_view str) {
+        if (str == "*")
+            return Converted<StatusCode>{Wildcard()};
+        Converted<int> code = parseInteger<int>(str);
+        if (code && (code.value < 100 || code.value > 599))
+            code.error = ConversionError::OUT_OF_RANGE;
+        if (!code)
+            return Converted<StatusCode>{Wildcard(), code.error};
+        return Converted<StatusCode>{StatusCode(code.value)};
+    }
+
     operator int() const { return (value); }
 };
 
@@ -30,6 +156,12 @@ struct PortNumber {
             throw std::out_of_range("Port number must be between 0 and 65535");
     }
 
+    /// @brief Parse a port number {0 <= port <= 65535}.
+    inline static Converted<PortNumber> parse(std::string_view str) {
+        Converted<uint16_t> port = parseInteger<uint16_t>(str);
+        return Converted<PortNumber>{PortNumber(port.value), port.error};
+    }
+
     operator int() const { return (value); }
 };
 
@@ -41,6 +173,11 @@ struct DefaultVal {
     operator bool() const { return (value); }
 };
 
+struct CgiExtension {
+    InternedString extension;
+    InternedString interpreter;
+};
+
 class Size {
 private:
 	size_t _size;
@@ -53,6 +190,8 @@ Size() = default;
 	Size &operator=(const Size &other) = default;
     ~Size() = default;
 
+	static Converted<Size> parse(std::string_view str);
+
 	size_t get() const;
 };
 
@@ -68,31 +207,41 @@ public:
     Timespan &operator=(const Timespan &other) = default;
     ~Timespan() = default;
 
+    static Converted<Timespan> parse(std::string_view str);
+
     double getSeconds() const;
 };
 
 class Path {
 private:
-	std::string _path;
+	InternedString _path;
 	bool _is_set;
 
 public:
     Path();
 	Path(const std::string &str);
+	Path(std::string &&str);
+	Path(const InternedString &str);
 	Path(const Path &other);
 	Path &operator=(const Path &other);
+	Path(Path &&other) = default;
+	Path &operator=(Path &&other) = default;
 
 	static Path createFromUrl(const std::string &url, const LocationRule &route);
+	static size_t createFromPath(std::string_view path, const LocationRule &route, std::span<char> buffer);
+	static size_t normalizeUrl(std::string_view url, std::span<char> buffer);
 	static Path createDummy();
 
 	Path &pop();
 	Path &append(const std::string &str);
 	Path &updateFromUrl(const std::string &route, const std::string &root);
 
-	std::string getFilename() const;
+	std::string_view getFilename() const;
 	const std::string &str() const;
+	bool isSet() const;
 	bool isValid() const;
 };
 
+std::ostream &operator<<(std::ostream &os, const InternedString &str);
 std::ostream &operator<<(std::ostream &os, const Size &size);
 std::ostream &operator<<(std::ostream &os, const Path &path);
\ No newline at end of file
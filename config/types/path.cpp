@@ -4,14 +4,25 @@
 
 #include <filesystem>
 #include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <cstring>
 
 Path::Path(const std::string &str) : _path(std::string(str)) {
 	_is_set = true;
 }
 
+Path::Path(const InternedString &str) : _path(str) {
+	_is_set = true;
+}
+
+Path::Path(std::string &&str) : _path(std::move(str)) {
+	_is_set = true;
+}
+
 Path::Path(const Path &other) : _path(other._path), _is_set(other._is_set) {}
 
-Path::Path() : _path(""), _is_set(false) {}
+Path::Path() : _path(), _is_set(false) {}
 
 Path &Path::operator=(const Path &other) {
 	if (this != &other) {
@@ -30,17 +41,21 @@ Path Path::createDummy() {
 /// @param str The subpath to append
 /// @return A reference to itself for chaining
 /// @details Appending an absolute path (starting with '/') will replace the current path.
+/// The path is immutable shared storage, so the result is built into a new string.
 Path &Path::append(const std::string &str) {
 	if (str.empty()) return *this;
-	if (_path.empty() || str.front() == '/') {
-		_path = std::string(str);
+	const std::string &current = _path.str();
+	if (current.empty() || str.front() == '/') {
+		_path = InternedString(std::string(str));
 		return *this;
 	} else {
-		if (_path.back() == '/') {
-			_path += str;
-		} else {
-			_path += '/' + str;
-		}
+		std::string result;
+		result.reserve(current.length() + str.length() + 1);
+		result += current;
+		if (current.back() != '/')
+			result += '/';
+		result += str;
+		_path = InternedString(std::move(result));
 		return *this;
 	}
 }
@@ -53,11 +68,13 @@ Path &Path::append(const std::string &str) {
 /// It replaces the beginning of the path with the root directory.
 Path &Path::updateFromUrl(const std::string &route, const std::string &root) {
 	size_t root_len = root.length();
+	std::string result = _path.str();
 
-	_path.replace(0, route.length(), root);
-	if (_path[root_len] && _path[root_len] != '/')
-		_path.insert(root_len, "/");
-	if (_path.back() == '/') _path.pop_back();
+	result.replace(0, route.length(), root);
+	if (result[root_len] && result[root_len] != '/')
+		result.insert(root_len, "/");
+	if (!result.empty() && result.back() == '/') result.pop_back();
+	_path = InternedString(std::move(result));
 
 	return *this;
 }
@@ -65,53 +82,218 @@ Path &Path::updateFromUrl(const std::string &route, const std::string &root) {
 /// @brief Remove the last segment of the path - either a file or a directory.
 /// @return A reference to itself for chaining
 Path &Path::pop() {
-	if (_path.empty()) return *this;
+	const std::string &current = _path.str();
+	if (current.empty()) return *this;
 
-	size_t last_slash = _path.find_last_of('/');
+	size_t last_slash = current.find_last_of('/');
 	if (last_slash == std::string::npos) {
-		_path.clear();
+		_path = InternedString(std::string());
 	} else {
-		_path.erase(last_slash);
+		_path = InternedString(current.substr(0, last_slash));
 	}
 
 	return *this;
 }
 
+/// @brief Characters that interrupt the bulk copy of a URL segment in Path::normalizeUrl.
+static constexpr std::array<bool, 256> createUrlSpecialTable() {
+	std::array<bool, 256> table{};
+	table['%'] = true;
+	table['/'] = true;
+	table['?'] = true;
+	table['#'] = true;
+	table['\0'] = true;
+	return table;
+}
+
+static constexpr std::array<bool, 256> urlSpecialTable = createUrlSpecialTable();
+
+static int hexValue(char c) {
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+/// @brief Finish the segment that starts at segmentStart: collapse empty segments, drop "." and resolve "..".
+/// @return False if a ".." segment would escape the root.
+static bool closeSegment(char *out, size_t &length, size_t &segmentStart, bool addSlash) {
+	std::string_view segment(out + segmentStart, length - segmentStart);
+
+	if (segment.empty())
+		return true;
+	if (segment == ".") {
+		length = segmentStart;
+		return true;
+	}
+	if (segment == "..") {
+		if (segmentStart == 1)
+			return false;
+		size_t previousStart = segmentStart - 1;
+		while (out[previousStart - 1] != '/')
+			--previousStart;
+		length = previousStart;
+		segmentStart = previousStart;
+		return true;
+	}
+
+	if (addSlash) {
+		out[length++] = '/';
+		segmentStart = length;
+	}
+	return true;
+}
+
+/// @brief Normalize the path of a URL in a single pass: the query string and fragment are dropped,
+/// percent-encoding is decoded, duplicate slashes are collapsed and dot-segments are resolved.
+/// @param url The URL to normalize.
+/// @param buffer The buffer to write the null-terminated normalized path into - it always starts with a '/'.
+/// @return The length of the normalized path, or std::string::npos if the URL contains a NUL byte or an invalid
+/// percent-encoding, tries to escape the root with "..", or does not fit in the buffer.
+size_t Path::normalizeUrl(std::string_view url, std::span<char> buffer) {
+	if (buffer.size() < 2)
+		return std::string::npos;
+
+	char *out = buffer.data();
+	size_t capacity = buffer.size() - 1;
+	size_t length = 0;
+	size_t segmentStart = 1;
+	out[length++] = '/';
+
+	size_t i = 0;
+	while (i < url.length()) {
+		size_t runEnd = i;
+		while (runEnd < url.length() && !urlSpecialTable[static_cast<unsigned char>(url[runEnd])])
+			++runEnd;
+		if (runEnd > i) {
+			if (length + (runEnd - i) > capacity)
+				return std::string::npos;
+			std::memcpy(out + length, url.data() + i, runEnd - i);
+			length += runEnd - i;
+			i = runEnd;
+			continue;
+		}
+
+		char c = url[i++];
+		if (c == '?' || c == '#')
+			break;
+		if (c == '%') {
+			if (i + 2 > url.length() || hexValue(url[i]) < 0 || hexValue(url[i + 1]) < 0)
+				return std::string::npos;
+			c = static_cast<char>(hexValue(url[i]) * 16 + hexValue(url[i + 1]));
+			i += 2;
+		}
+
+		if (c == '\0')
+			return std::string::npos;
+		if (c == '/') {
+			if (length + 1 > capacity || !closeSegment(out, length, segmentStart, true))
+				return std::string::npos;
+			continue;
+		}
+
+		if (length + 1 > capacity)
+			return std::string::npos;
+		out[length++] = c;
+	}
+
+	if (!closeSegment(out, length, segmentStart, false))
+		return std::string::npos;
+
+	out[length] = '\0';
+	return length;
+}
+
 /// @brief Create a Path object from a URL and a route.
 /// @param url The URL to create the path from.
-/// @param route The rules for the URL
+/// @param route The rules for the URL - the location that ServerConfig::getRoute() returned for the normalized URL.
 /// @return A path to the file or directory represented by the URL.
 Path Path::createFromUrl(const std::string &url, const LocationRule &route) {
-	if (url.empty() || !route.root.isSet())
+	std::string path(route.getMappedRoot().length() + url.length() + 3, '\0');
+	std::span<char> buffer(path.data(), path.size());
+
+	size_t length = Path::normalizeUrl(url, buffer);
+	if (length != std::string::npos)
+		length = Path::createFromPath(std::string_view(path.data(), length), route, buffer);
+	if (length == std::string::npos)
 		return Path::createDummy();
 
-	Path path(url.substr(0, url.find('?')));
-	path.updateFromUrl(route.path.str(), route.root.getRootPath().str());
+	path.resize(length);
+	return Path(std::move(path));
+}
+
+/// @brief Map a normalized path to a filesystem path without allocating, by writing it into a caller-provided buffer:
+/// the matched location prefix is cut out and the root is put in front of the rest.
+/// A request is normalized once (see Path::normalizeUrl), and that same path is routed with ServerConfig::getRoute()
+/// and mapped here - so the location that is applied is always the location of the file that is served.
+/// @param path The normalized path. It may be stored at the start of the buffer, in which case it is mapped in place.
+/// @param route The rules for the path, with the root and prefix length precomputed.
+/// @param buffer The buffer to write the null-terminated path into.
+/// @return The length of the path (excluding the null terminator), or std::string::npos if the
+/// route has no root or the buffer is too small.
+size_t Path::createFromPath(std::string_view path, const LocationRule &route, std::span<char> buffer) {
+	if (path.empty() || !route.root.isSet())
+		return std::string::npos;
+
+	std::string_view root = route.getMappedRoot();
+	size_t prefixLength = route.getUrlPrefixLength();
+	if (prefixLength > path.length() || std::memcmp(path.data(), route.path.str().data(), prefixLength) != 0)
+		prefixLength = 0;
+
+	std::string_view rest = path.substr(prefixLength);
+	if (!rest.empty() && rest.back() == '/')
+		rest.remove_suffix(1);
+
+	bool needsSlash = (!rest.empty() && rest.front() != '/') || (rest.empty() && root.empty());
+	size_t length = root.length() + needsSlash + rest.length();
+	if (length >= buffer.size())
+		return std::string::npos;
 
-	return path;
+	std::memmove(buffer.data() + root.length() + needsSlash, rest.data(), rest.length());
+	std::memcpy(buffer.data(), root.data(), root.length());
+	if (needsSlash)
+		buffer[root.length()] = '/';
+	buffer[length] = '\0';
+
+	return length;
 }
 
 /// @brief Get the filename from the path. If the path is a directory, it returns the last segment.
-/// @return The filename or the last segment of the path.
-std::string Path::getFilename() const {
-	if (_path.empty()) return "";
+/// @return The filename or the last segment of the path - a view into the storage of the path, which lives as long as any copy of it.
+std::string_view Path::getFilename() const {
+	std::string_view current = _path.str();
+
+	size_t last_slash = current.find_last_of('/');
+	if (last_slash == std::string_view::npos)
+		return current;
+	return current.substr(last_slash + 1);
+}
 
-	size_t last_slash = _path.find_last_of('/');
-	if (last_slash == std::string::npos)
-		return _path;
-	else
-		return _path.substr(last_slash + 1);
+/// @brief Check if the path is set (i.e., it is not a dummy path).
+bool Path::isSet() const {
+	return _is_set;
 }
 
-/// @brief Check if the path is valid. For this it has to be set and not contain ".." segments. 
+/// @brief Check if the path is valid. For this it has to be set and not contain ".." segments or NUL bytes.
 bool Path::isValid() const {
-	return (_is_set && _path.find("..") == std::string::npos);
+	const std::string &path = _path.str();
+	if (!_is_set || path.find('\0') != std::string::npos)
+		return false;
+
+	size_t segmentStart = 0;
+	while (segmentStart <= path.length()) {
+		size_t segmentEnd = std::min(path.find('/', segmentStart), path.length());
+		if (segmentEnd - segmentStart == 2 && path.compare(segmentStart, 2, "..") == 0)
+			return false;
+		segmentStart = segmentEnd + 1;
+	}
+	return true;
 }
 
 /// @brief Get the string representation of the path.
 /// @return A constant reference to the path string.
 const std::string &Path::str() const {
-	return _path;
+	return _path.str();
 }
 
 std::ostream &operator<<(std::ostream &os, const Path &path) {
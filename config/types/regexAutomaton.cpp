@@ -0,0 +1,632 @@
+#include "regexAutomaton.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+/// @brief A node of the parsed pattern, before it is turned into states.
+struct Node {
+    enum Kind {
+        EMPTY,
+        CLASS,
+        ASSERTION,
+        CONCAT,
+        ALTERNATION,
+        REPEAT,
+    };
+
+    Kind kind = EMPTY;
+    uint32_t value = 0;
+    uint32_t min = 0;
+    uint32_t max = 0;
+    std::vector<Node> children{};
+};
+
+constexpr uint32_t REPEAT_INFINITE = UINT32_MAX;
+
+/// @brief What an escape sequence stands for.
+enum EscapeKind {
+    ESCAPE_CHARACTER,
+    ESCAPE_CLASS,
+    ESCAPE_ASSERTION,
+};
+
+void addByte(RegexAutomaton::CharClass &charClass, unsigned char c) {
+    charClass[c >> 6] |= (uint64_t(1) << (c & 63));
+}
+
+void addRange(RegexAutomaton::CharClass &charClass, unsigned char from, unsigned char to) {
+    for (unsigned c = from; c <= to; ++c)
+        addByte(charClass, static_cast<unsigned char>(c));
+}
+
+void invert(RegexAutomaton::CharClass &charClass) {
+    for (uint64_t &bits : charClass)
+        bits = ~bits;
+}
+
+void merge(RegexAutomaton::CharClass &charClass, const RegexAutomaton::CharClass &other) {
+    for (size_t i = 0; i < charClass.size(); ++i)
+        charClass[i] |= other[i];
+}
+
+bool isWordCharacter(unsigned char c) {
+    return ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_');
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return (c - '0');
+    if (c >= 'a' && c <= 'f') return (c - 'a' + 10);
+    if (c >= 'A' && c <= 'F') return (c - 'A' + 10);
+    return (-1);
+}
+
+/// @brief The number of states a node turns into, saturated at the maximum, so huge counted repetitions are rejected
+/// before they are expanded.
+uint64_t stateCount(const Node &node) {
+    constexpr uint64_t limit = uint64_t(REGEX_AUTOMATON_MAX_STATES) + 1;
+    uint64_t count = 0;
+
+    switch (node.kind) {
+        case Node::EMPTY: return (0);
+        case Node::CLASS: case Node::ASSERTION: return (1);
+        case Node::CONCAT:
+        case Node::ALTERNATION:
+            for (const Node &child : node.children)
+                count += stateCount(child);
+            if (node.kind == Node::ALTERNATION)
+                count += node.children.size() - 1;
+            return (std::min(count, limit));
+        case Node::REPEAT: {
+            uint64_t child = stateCount(node.children[0]);
+            uint64_t optional = (node.max == REPEAT_INFINITE) ? 1 : node.max - node.min;
+            count = node.min * child + optional * (child + 1);
+            return (std::min(count, limit));
+        }
+    }
+    return (limit);
+}
+
+}
+
+/// @brief Parses one pattern (recursive descent over the pattern, which is part of the trusted configuration) and
+/// emits its states into the automaton.
+class RegexAutomaton::Compiler {
+private:
+    RegexAutomaton &_automaton;
+    std::string_view _pattern;
+    size_t _pos = 0;
+    std::string _error;
+
+    bool _fail(const std::string &message) {
+        if (_error.empty())
+            _error = message + " at offset " + std::to_string(_pos);
+        return (false);
+    }
+
+    bool _atEnd() const { return (_pos >= _pattern.size()); }
+    char _peek() const { return (_atEnd() ? '\0' : _pattern[_pos]); }
+
+    uint32_t _addClass(const CharClass &charClass) {
+        std::vector<CharClass> &classes = _automaton._classes;
+        auto it = std::find(classes.begin(), classes.end(), charClass);
+        if (it != classes.end())
+            return (static_cast<uint32_t>(it - classes.begin()));
+        classes.push_back(charClass);
+        return (static_cast<uint32_t>(classes.size() - 1));
+    }
+
+    Node _classNode(const CharClass &charClass) {
+        Node node;
+        node.kind = Node::CLASS;
+        node.value = _addClass(charClass);
+        return (node);
+    }
+
+    uint32_t _newState(StateType type, uint32_t next, uint32_t argument) {
+        _automaton._states.push_back(State{type, next, argument});
+        return (static_cast<uint32_t>(_automaton._states.size() - 1));
+    }
+
+    bool _parseDisjunction(Node &node);
+    bool _parseAlternative(Node &node);
+    bool _parseTerm(Node &node);
+    bool _parseQuantifier(Node &node);
+    bool _parseNumber(uint32_t &number);
+    bool _parseClass(Node &node);
+    bool _parseClassAtom(CharClass &charClass, int &character);
+    bool _parseEscape(bool inClass, CharClass &charClass, int &character, EscapeKind &kind, StateType &assertion);
+    uint32_t _emit(const Node &node, uint32_t next);
+
+public:
+    Compiler(RegexAutomaton &automaton, std::string_view pattern) : _automaton(automaton), _pattern(pattern) {}
+
+    bool compile(uint32_t id);
+    const std::string &getError() const { return (_error); }
+};
+
+bool RegexAutomaton::Compiler::_parseDisjunction(Node &node) {
+    Node alternative;
+    if (!_parseAlternative(alternative))
+        return (false);
+    if (_peek() != '|') {
+        node = std::move(alternative);
+        return (true);
+    }
+
+    node.kind = Node::ALTERNATION;
+    node.children.push_back(std::move(alternative));
+    while (_peek() == '|') {
+        ++_pos;
+        if (!_parseAlternative(alternative))
+            return (false);
+        node.children.push_back(std::move(alternative));
+    }
+    return (true);
+}
+
+bool RegexAutomaton::Compiler::_parseAlternative(Node &node) {
+    node = Node{};
+    node.kind = Node::CONCAT;
+    while (!_atEnd() && _peek() != '|' && _peek() != ')') {
+        Node term;
+        if (!_parseTerm(term))
+            return (false);
+        node.children.push_back(std::move(term));
+    }
+    return (true);
+}
+
+bool RegexAutomaton::Compiler::_parseTerm(Node &node) {
+    char c = _pattern[_pos++];
+    CharClass charClass{};
+    int character = -1;
+    bool quantifiable = true;
+
+    switch (c) {
+        case '^':
+        case '$':
+            node.kind = Node::ASSERTION;
+            node.value = (c == '^') ? ASSERT_BEGIN : ASSERT_END;
+            quantifiable = false;
+            break ;
+        case '.':
+            addRange(charClass, 0, 255);
+            charClass['\n' >> 6] &= ~(uint64_t(1) << ('\n' & 63));
+            charClass['\r' >> 6] &= ~(uint64_t(1) << ('\r' & 63));
+            node = _classNode(charClass);
+            break ;
+        case '(':
+            if (_peek() == '?') {
+                ++_pos;
+                if (_peek() == '=' || _peek() == '!')
+                    return (_fail("Lookahead assertions are not supported"));
+                if (_peek() != ':')
+                    return (_fail("Lookbehind assertions and named groups are not supported"));
+                ++_pos;
+            }
+            if (!_parseDisjunction(node))
+                return (false);
+            if (_peek() != ')')
+                return (_fail("Missing ')'"));
+            ++_pos;
+            break ;
+        case '[':
+            if (!_parseClass(node))
+                return (false);
+            break ;
+        case '\\': {
+            EscapeKind kind = ESCAPE_CHARACTER;
+            StateType assertion = WORD_BOUNDARY;
+            if (!_parseEscape(false, charClass, character, kind, assertion))
+                return (false);
+            if (kind == ESCAPE_ASSERTION) {
+                node.kind = Node::ASSERTION;
+                node.value = assertion;
+                quantifiable = false;
+                break ;
+            }
+            if (kind == ESCAPE_CHARACTER)
+                addByte(charClass, static_cast<unsigned char>(character));
+            node = _classNode(charClass);
+            break ;
+        }
+        case '*': case '+': case '?': case '{':
+            --_pos;
+            return (_fail("Nothing to repeat"));
+        default:
+            addByte(charClass, static_cast<unsigned char>(c));
+            node = _classNode(charClass);
+            break ;
+    }
+
+    char next = _peek();
+    if (next != '*' && next != '+' && next != '?' && next != '{')
+        return (true);
+    if (!quantifiable)
+        return (_fail("Nothing to repeat"));
+    return (_parseQuantifier(node));
+}
+
+bool RegexAutomaton::Compiler::_parseNumber(uint32_t &number) {
+    size_t start = _pos;
+    uint64_t value = 0;
+
+    while (_peek() >= '0' && _peek() <= '9') {
+        value = std::min<uint64_t>(value * 10 + (_peek() - '0'), uint64_t(REGEX_AUTOMATON_MAX_REPEAT) + 1);
+        ++_pos;
+    }
+    number = static_cast<uint32_t>(value);
+    return (_pos != start);
+}
+
+/// @brief Wrap a node in the quantifier that follows it. Lazy quantifiers match the same inputs as greedy ones, so the
+/// difference is ignored - the automaton only decides whether a pattern matches.
+bool RegexAutomaton::Compiler::_parseQuantifier(Node &node) {
+    uint32_t min = 0;
+    uint32_t max = REPEAT_INFINITE;
+
+    switch (_pattern[_pos++]) {
+        case '*': break ;
+        case '+': min = 1; break ;
+        case '?': max = 1; break ;
+        default:
+            if (!_parseNumber(min))
+                return (_fail("Invalid quantifier"));
+            max = min;
+            if (_peek() == ',') {
+                ++_pos;
+                max = REPEAT_INFINITE;
+                if (_peek() != '}' && !_parseNumber(max))
+                    return (_fail("Invalid quantifier"));
+            }
+            if (_peek() != '}')
+                return (_fail("Invalid quantifier"));
+            ++_pos;
+            if (max < min)
+                return (_fail("Numbers out of order in quantifier"));
+            if (min > REGEX_AUTOMATON_MAX_REPEAT || (max != REPEAT_INFINITE && max > REGEX_AUTOMATON_MAX_REPEAT))
+                return (_fail("Quantifier is larger than " + std::to_string(REGEX_AUTOMATON_MAX_REPEAT)));
+    }
+    if (_peek() == '?')
+        ++_pos;
+
+    Node repeat;
+    repeat.kind = Node::REPEAT;
+    repeat.min = min;
+    repeat.max = max;
+    repeat.children.push_back(std::move(node));
+    node = std::move(repeat);
+
+    char next = _peek();
+    if (next == '*' || next == '+' || next == '?' || next == '{')
+        return (_fail("Nothing to repeat"));
+    return (true);
+}
+
+bool RegexAutomaton::Compiler::_parseClass(Node &node) {
+    CharClass charClass{};
+    bool negated = (_peek() == '^');
+
+    if (negated)
+        ++_pos;
+    while (_peek() != ']') {
+        if (_atEnd())
+            return (_fail("Missing ']'"));
+
+        CharClass atom{};
+        int from = -1;
+        if (!_parseClassAtom(atom, from))
+            return (false);
+        if (from < 0 || _peek() != '-' || _pos + 1 >= _pattern.size() || _pattern[_pos + 1] == ']') {
+            if (from >= 0)
+                addByte(atom, static_cast<unsigned char>(from));
+            merge(charClass, atom);
+            continue;
+        }
+
+        ++_pos;
+        int to = -1;
+        if (!_parseClassAtom(atom, to))
+            return (false);
+        if (to < 0)
+            return (_fail("Invalid range in character class"));
+        if (to < from)
+            return (_fail("Range out of order in character class"));
+        addRange(charClass, static_cast<unsigned char>(from), static_cast<unsigned char>(to));
+    }
+    ++_pos;
+
+    if (negated)
+        invert(charClass);
+    node = _classNode(charClass);
+    return (true);
+}
+
+/// @param character Set to the character of the atom, or to -1 if the atom is a class escape (added to charClass).
+bool RegexAutomaton::Compiler::_parseClassAtom(CharClass &charClass, int &character) {
+    char c = _pattern[_pos++];
+
+    if (c != '\\') {
+        character = static_cast<unsigned char>(c);
+        return (true);
+    }
+
+    EscapeKind kind = ESCAPE_CHARACTER;
+    StateType assertion = WORD_BOUNDARY;
+    if (!_parseEscape(true, charClass, character, kind, assertion))
+        return (false);
+    if (kind == ESCAPE_CLASS)
+        character = -1;
+    return (true);
+}
+
+/// @brief Parse the escape sequence after a backslash.
+bool RegexAutomaton::Compiler::_parseEscape(bool inClass, CharClass &charClass, int &character, EscapeKind &kind,
+    StateType &assertion) {
+    if (_atEnd())
+        return (_fail("Trailing backslash"));
+
+    char c = _pattern[_pos++];
+    CharClass escapeClass{};
+    kind = ESCAPE_CHARACTER;
+
+    switch (c) {
+        case 'd': case 'D':
+            addRange(escapeClass, '0', '9');
+            break ;
+        case 'w': case 'W':
+            addRange(escapeClass, 'a', 'z');
+            addRange(escapeClass, 'A', 'Z');
+            addRange(escapeClass, '0', '9');
+            addByte(escapeClass, '_');
+            break ;
+        case 's': case 'S':
+            for (char space : {' ', '\t', '\n', '\v', '\f', '\r'})
+                addByte(escapeClass, static_cast<unsigned char>(space));
+            break ;
+        case 'b':
+            if (inClass) {
+                character = '\b';
+                return (true);
+            }
+            kind = ESCAPE_ASSERTION;
+            assertion = WORD_BOUNDARY;
+            return (true);
+        case 'B':
+            if (inClass)
+                return (_fail("Invalid escape in character class"));
+            kind = ESCAPE_ASSERTION;
+            assertion = NOT_WORD_BOUNDARY;
+            return (true);
+        case 't': character = '\t'; return (true);
+        case 'n': character = '\n'; return (true);
+        case 'v': character = '\v'; return (true);
+        case 'f': character = '\f'; return (true);
+        case 'r': character = '\r'; return (true);
+        case '0':
+            if (_peek() >= '0' && _peek() <= '9')
+                return (_fail("Octal escapes are not supported"));
+            character = '\0';
+            return (true);
+        case 'c':
+            if (!((_peek() >= 'a' && _peek() <= 'z') || (_peek() >= 'A' && _peek() <= 'Z')))
+                return (_fail("Invalid control escape"));
+            character = _pattern[_pos++] % 32;
+            return (true);
+        case 'x':
+        case 'u': {
+            size_t digits = (c == 'x') ? 2 : 4;
+            int value = 0;
+            for (size_t i = 0; i < digits; ++i) {
+                int digit = hexValue(_peek());
+                if (digit < 0)
+                    return (_fail("Invalid hexadecimal escape"));
+                value = value * 16 + digit;
+                ++_pos;
+            }
+            if (value > 0xff)
+                return (_fail("Characters above \\xff are not supported"));
+            character = value;
+            return (true);
+        }
+        default:
+            if (c >= '1' && c <= '9')
+                return (_fail("Back references are not supported"));
+            character = static_cast<unsigned char>(c);
+            return (true);
+    }
+
+    if (c >= 'A' && c <= 'Z')
+        invert(escapeClass);
+    merge(charClass, escapeClass);
+    kind = ESCAPE_CLASS;
+    return (true);
+}
+
+/// @brief Turn a node into states, back to front: every node is emitted with the state that follows it already known.
+/// @return The first state of the node.
+uint32_t RegexAutomaton::Compiler::_emit(const Node &node, uint32_t next) {
+    switch (node.kind) {
+        case Node::EMPTY:
+            return (next);
+        case Node::CLASS:
+            return (_newState(CHAR_CLASS, next, node.value));
+        case Node::ASSERTION:
+            return (_newState(static_cast<StateType>(node.value), next, 0));
+        case Node::CONCAT:
+            for (auto it = node.children.rbegin(); it != node.children.rend(); ++it)
+                next = _emit(*it, next);
+            return (next);
+        case Node::ALTERNATION: {
+            uint32_t start = _emit(node.children.back(), next);
+            for (size_t i = node.children.size() - 1; i-- > 0; )
+                start = _newState(SPLIT, _emit(node.children[i], next), start);
+            return (start);
+        }
+        case Node::REPEAT: {
+            uint32_t start = next;
+            if (node.max == REPEAT_INFINITE) {
+                start = _newState(SPLIT, 0, next);
+                _automaton._states[start].next = _emit(node.children[0], start);
+            } else {
+                for (uint32_t i = node.min; i < node.max; ++i)
+                    start = _newState(SPLIT, _emit(node.children[0], start), next);
+            }
+            for (uint32_t i = 0; i < node.min; ++i)
+                start = _emit(node.children[0], start);
+            return (start);
+        }
+    }
+    return (next);
+}
+
+bool RegexAutomaton::Compiler::compile(uint32_t id) {
+    Node root;
+
+    if (!_parseDisjunction(root))
+        return (false);
+    if (!_atEnd())
+        return (_fail("Unmatched ')'"));
+    if (stateCount(root) > REGEX_AUTOMATON_MAX_STATES)
+        return (_fail("Pattern is too complex (more than " + std::to_string(REGEX_AUTOMATON_MAX_STATES) + " states)"));
+
+    uint32_t match = _newState(MATCH, 0, id);
+    _automaton._starts.push_back(_emit(root, match));
+    return (true);
+}
+
+/// @brief Check if a pattern can be compiled, without keeping it.
+/// @param error Set to the reason if it cannot.
+bool RegexAutomaton::validate(std::string_view pattern, std::string &error) {
+    RegexAutomaton automaton;
+    return (automaton.add(pattern, error));
+}
+
+bool RegexAutomaton::contains(const CharClass &charClass, unsigned char c) {
+    return ((charClass[c >> 6] >> (c & 63)) & 1);
+}
+
+/// @brief Compile a pattern into the automaton. Its id is the number of patterns that were added before it.
+/// @param error Set to the reason if the pattern cannot be compiled - the automaton is left unchanged then.
+bool RegexAutomaton::add(std::string_view pattern, std::string &error) {
+    size_t stateCount = _states.size();
+    size_t classCount = _classes.size();
+    Compiler compiler(*this, pattern);
+
+    if (compiler.compile(static_cast<uint32_t>(_starts.size())))
+        return (true);
+    _states.resize(stateCount);
+    _classes.resize(classCount);
+    error = compiler.getError();
+    return (false);
+}
+
+namespace {
+
+/// @brief The thread lists of a simulation, kept per thread so matching does not allocate once they have grown.
+struct Simulation {
+    std::vector<uint32_t> current;
+    std::vector<uint32_t> next;
+    std::vector<uint32_t> stack;
+    std::vector<uint32_t> marks;
+    uint32_t generation = 0;
+
+    void begin(size_t stateCount) {
+        if (marks.size() < stateCount)
+            marks.resize(stateCount, 0);
+        current.clear();
+        nextGeneration();
+    }
+
+    void nextGeneration() {
+        if (++generation == 0) {
+            std::fill(marks.begin(), marks.end(), 0);
+            generation = 1;
+        }
+    }
+};
+
+/// @brief Add a state to a thread list, following every epsilon transition (with an explicit stack) at a position.
+void addThread(const std::vector<RegexAutomaton::State> &states, Simulation &simulation, std::vector<uint32_t> &list,
+    uint32_t state, size_t position, std::string_view input, uint32_t &matched) {
+    bool before = position > 0 && isWordCharacter(static_cast<unsigned char>(input[position - 1]));
+    bool after = position < input.size() && isWordCharacter(static_cast<unsigned char>(input[position]));
+
+    simulation.stack.push_back(state);
+
+    while (!simulation.stack.empty()) {
+        uint32_t current = simulation.stack.back();
+        simulation.stack.pop_back();
+        if (simulation.marks[current] == simulation.generation)
+            continue;
+        simulation.marks[current] = simulation.generation;
+
+        const RegexAutomaton::State &s = states[current];
+
+        switch (s.type) {
+            case RegexAutomaton::CHAR_CLASS: list.push_back(current); break ;
+            case RegexAutomaton::MATCH: matched = std::min(matched, s.argument); break ;
+            case RegexAutomaton::SPLIT:
+                simulation.stack.push_back(s.argument);
+                simulation.stack.push_back(s.next);
+                break ;
+            case RegexAutomaton::ASSERT_BEGIN: if (position == 0) simulation.stack.push_back(s.next); break ;
+            case RegexAutomaton::ASSERT_END: if (position == input.size()) simulation.stack.push_back(s.next); break ;
+            case RegexAutomaton::WORD_BOUNDARY: if (before != after) simulation.stack.push_back(s.next); break ;
+            case RegexAutomaton::NOT_WORD_BOUNDARY: if (before == after) simulation.stack.push_back(s.next); break ;
+        }
+    }
+}
+
+}
+
+/// @brief Find the first pattern (in the order they were added) that matches anywhere in the input.
+/// Every pattern starts a new thread at every position, and all threads advance together over the input - so the input
+/// is read once, and the work per character is bounded by the number of states.
+/// @return The id of the pattern, or NO_MATCH.
+uint32_t RegexAutomaton::firstMatch(std::string_view input) const {
+    static thread_local Simulation simulation;
+    uint32_t matched = NO_MATCH;
+
+    if (_starts.empty())
+        return (NO_MATCH);
+    simulation.begin(_states.size());
+
+    for (size_t position = 0; ; ++position) {
+        for (uint32_t start : _starts)
+            addThread(_states, simulation, simulation.current, start, position, input, matched);
+        if (matched == 0 || position == input.size())
+            break ;
+
+        unsigned char c = static_cast<unsigned char>(input[position]);
+        simulation.next.clear();
+        simulation.nextGeneration();
+        for (uint32_t state : simulation.current)
+            if (contains(_classes[_states[state].argument], c))
+                addThread(_states, simulation, simulation.next, _states[state].next, position + 1, input, matched);
+        simulation.current.swap(simulation.next);
+    }
+    return (matched);
+}
+
+bool RegexAutomaton::empty() const {
+    return (_starts.empty());
+}
+
+size_t RegexAutomaton::getPatternCount() const {
+    return (_starts.size());
+}
+
+const std::vector<RegexAutomaton::State> &RegexAutomaton::getStates() const {
+    return (_states);
+}
+
+const std::vector<RegexAutomaton::CharClass> &RegexAutomaton::getClasses() const {
+    return (_classes);
+}
+
+const std::vector<uint32_t> &RegexAutomaton::getStarts() const {
+    return (_starts);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+
+#define REGEX_AUTOMATON_MAX_STATES 4096
+#define REGEX_AUTOMATON_MAX_REPEAT 1000
+
+/// @brief Matches a set of regular expressions against an input in a single pass, without recursion and without backtracking.
+/// Every pattern is compiled into one shared NFA (Thompson's construction), which is simulated over the input one character
+/// at a time - the cost is linear in the length of the input, whatever the patterns look like, and the stack usage is constant.
+/// The patterns use the ECMAScript syntax without the features that need backtracking: back references and lookarounds are
+/// rejected when a pattern is added. A pattern matches if it matches anywhere in the input (like std::regex_search).
+/// @note A built automaton is immutable, so any number of threads may match against it at the same time.
+class RegexAutomaton {
+public:
+    enum StateType : uint8_t {
+        /// Consume one character of the class `argument`, then continue with `next`.
+        CHAR_CLASS = 0,
+        /// Continue with both `next` and `argument`.
+        SPLIT = 1,
+        /// Pattern `argument` matched.
+        MATCH = 2,
+        ASSERT_BEGIN = 3,
+        ASSERT_END = 4,
+        WORD_BOUNDARY = 5,
+        NOT_WORD_BOUNDARY = 6,
+    };
+
+    struct State {
+        StateType type;
+        uint32_t next;
+        uint32_t argument;
+    };
+
+    /// @brief A set of bytes, as a 256-bit bitmap.
+    using CharClass = std::array<uint64_t, 4>;
+
+    constexpr static uint32_t NO_MATCH = UINT32_MAX;
+
+private:
+    std::vector<State> _states;
+    std::vector<CharClass> _classes;
+    std::vector<uint32_t> _starts;
+
+    class Compiler;
+
+public:
+    RegexAutomaton() = default;
+    RegexAutomaton(const RegexAutomaton &other) = default;
+    RegexAutomaton& operator=(const RegexAutomaton &other) = default;
+    RegexAutomaton(RegexAutomaton &&other) = default;
+    RegexAutomaton& operator=(RegexAutomaton &&other) = default;
+    ~RegexAutomaton() = default;
+
+    static bool validate(std::string_view pattern, std::string &error);
+    static bool contains(const CharClass &charClass, unsigned char c);
+
+    bool add(std::string_view pattern, std::string &error);
+    uint32_t firstMatch(std::string_view input) const;
+
+    bool empty() const;
+    size_t getPatternCount() const;
+    const std::vector<State> &getStates() const;
+    const std::vector<CharClass> &getClasses() const;
+    const std::vector<uint32_t> &getStarts() const;
+};
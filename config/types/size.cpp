@@ -4,31 +4,51 @@
 #include "../config.hpp"
 
 #include <iostream>
-#include <string.h>
-#include <cstring>
+#include <charconv>
+#include <limits>
 
 Size::Size(size_t size) : _size(size) {}
 
 Size::Size(const std::string &str) {
-    _size = std::stoul(str);
-
-	if (_size == 0)
-        throw std::invalid_argument("Size cannot be zero");
-    
-    for (size_t i = 0; i < str.size(); i++) {
-        if (!isdigit(str[i])) {
-            if (strncmp(str.c_str() + i, "kb", 3) == 0 || strncmp(str.c_str() + i, "Kb", 3) == 0)
-                _size *= 1024;
-            else if (strncmp(str.c_str() + i, "mb", 3) == 0 || strncmp(str.c_str() + i, "Mb", 3) == 0)
-                _size *= 1024 * 1024;
-            else if (strncmp(str.c_str() + i, "gb", 3) == 0 || strncmp(str.c_str() + i, "Gb", 3) == 0)
-                _size *= 1024 * 1024 * 1024;
-            else
-                throw std::invalid_argument("Invalid size multiplier");
-            break;
-        }
+    Converted<Size> size = parse(str);
+
+    if (!size)
+        throw std::invalid_argument(std::string("Invalid size: ") + getConversionErrorReason(size.error));
+    _size = size.value._size;
+}
+
+/// @brief Parse a size in bytes, optionally followed by a unit (kb, mb, gb). The size cannot be zero.
+/// @return The size, or the reason it could not be parsed.
+Converted<Size> Size::parse(std::string_view str) {
+    static const struct { std::string_view unit; size_t multiplier; } units[] = {
+        {"kb", 1024}, {"Kb", 1024},
+        {"mb", 1024 * 1024}, {"Mb", 1024 * 1024},
+        {"gb", 1024 * 1024 * 1024}, {"Gb", 1024 * 1024 * 1024},
+    };
+    size_t value = 0;
+
+    if (str.empty())
+        return Converted<Size>::failure(ConversionError::EMPTY);
+    auto [end, errc] = std::from_chars(str.data(), str.data() + str.size(), value);
+    if (errc == std::errc::result_out_of_range)
+        return Converted<Size>::failure(ConversionError::OUT_OF_RANGE);
+    if (errc != std::errc())
+        return Converted<Size>::failure(ConversionError::NOT_A_NUMBER);
+    if (value == 0)
+        return Converted<Size>::failure(ConversionError::OUT_OF_RANGE);
+
+    std::string_view unit(end, str.data() + str.size() - end);
+    if (unit.empty())
+        return Converted<Size>{Size(value)};
+    for (const auto &[name, multiplier] : units) {
+        if (unit != name)
+            continue;
+        if (value > std::numeric_limits<size_t>::max() / multiplier)
+            return Converted<Size>::failure(ConversionError::OUT_OF_RANGE);
+        return Converted<Size>{Size(value * multiplier)};
     }
-};
+    return Converted<Size>::failure(ConversionError::INVALID_UNIT);
+}
 
 /// @brief Get the size value
 /// @return The size value in bytes
@@ -0,0 +1,50 @@
+#include "customTypes.hpp"
+
+#include <ostream>
+#include <string>
+
+InternedString::InternedString(std::shared_ptr<const std::string> str) : _str(std::move(str)) {}
+
+InternedString::InternedString(std::string str) : _str(std::make_shared<const std::string>(std::move(str))) {}
+
+/// @brief Get the string value - an empty string if nothing was assigned.
+const std::string &InternedString::str() const {
+	static const std::string empty;
+
+	return (_str ? *_str : empty);
+}
+
+const char *InternedString::data() const {
+	return (str().data());
+}
+
+size_t InternedString::length() const {
+	return (str().length());
+}
+
+bool InternedString::empty() const {
+	return (str().empty());
+}
+
+/// @brief Compare two strings, which is a pointer comparison for strings from the same pool.
+bool InternedString::operator==(const InternedString &other) const {
+	return (_str == other._str || str() == other.str());
+}
+
+/// @brief Get the interned version of a string, adding it to the pool if it is not there yet.
+InternedString StringPool::intern(std::string_view str) {
+	auto it = _strings.find(str);
+	if (it == _strings.end())
+		it = _strings.insert(std::make_shared<const std::string>(str)).first;
+
+	return (InternedString(*it));
+}
+
+/// @brief Get the number of distinct strings in the pool.
+size_t StringPool::size() const {
+	return (_strings.size());
+}
+
+std::ostream &operator<<(std::ostream &os, const InternedString &str) {
+	return (os << str.str());
+}
@@ -4,38 +4,48 @@
 #include "../config.hpp"
 
 #include <iostream>
-#include <string.h>
-#include <cstring>
+#include <charconv>
+#include <limits>
+#include <cmath>
 
 Timespan::Timespan(std::string str) {
-    size_t pos;
-    _seconds = std::stod(str, &pos);
+    Converted<Timespan> timespan = parse(str);
 
-    if (_seconds < 0)
-        throw std::invalid_argument("Timespan cannot be negative");
+    if (!timespan)
+        throw std::invalid_argument(std::string("Invalid timespan: ") + getConversionErrorReason(timespan.error));
+    _seconds = timespan.value._seconds;
+}
+
+/// @brief Parse a non-negative time span, optionally followed by a unit (ns, us, ms, s, m, h, d, w, y). Without a unit the value is in seconds.
+/// @return The time span, or the reason it could not be parsed.
+Converted<Timespan> Timespan::parse(std::string_view str) {
+    static const struct { std::string_view unit; double multiplier; } units[] = {
+        {"ns", 1e-9}, {"us", 1e-6}, {"ms", 1e-3}, {"s", 1},
+        {"m", 60}, {"h", 3600}, {"d", 86400}, {"w", 604800}, {"y", 31536000},
+    };
+    double seconds = 0;
+
+    if (str.empty())
+        return Converted<Timespan>::failure(ConversionError::EMPTY);
+    auto [end, errc] = std::from_chars(str.data(), str.data() + str.size(), seconds);
+    if (errc == std::errc::result_out_of_range)
+        return Converted<Timespan>::failure(ConversionError::OUT_OF_RANGE);
+    if (errc != std::errc() || !std::isfinite(seconds))
+        return Converted<Timespan>::failure(ConversionError::NOT_A_NUMBER);
+    if (seconds < 0)
+        return Converted<Timespan>::failure(ConversionError::OUT_OF_RANGE);
 
-    if (pos == str.size())
-        return;
-    if (std::strncmp(str.c_str() + pos, "ns", 3) == 0)
-        _seconds *= 1e-9;
-    else if (std::strncmp(str.c_str() + pos, "us", 3) == 0)
-        _seconds *= 1e-6;
-    else if (std::strncmp(str.c_str() + pos, "ms", 3) == 0)
-        _seconds *= 1e-3;
-    else if (std::strncmp(str.c_str() + pos, "s", 2) == 0)
-        _seconds *= 1;
-    else if (std::strncmp(str.c_str() + pos, "m", 2) == 0)
-        _seconds *= 60;
-    else if (std::strncmp(str.c_str() + pos, "h", 2) == 0)
-        _seconds *= 3600;
-    else if (std::strncmp(str.c_str() + pos, "d", 2) == 0)
-        _seconds *= 86400;
-    else if (std::strncmp(str.c_str() + pos, "w", 2) == 0)
-        _seconds *= 604800;
-    else if (std::strncmp(str.c_str() + pos, "y", 2) == 0)
-        _seconds *= 31536000;
-    else
-        throw std::invalid_argument("Invalid timespan multiplier");
+    std::string_view unit(end, str.data() + str.size() - end);
+    if (unit.empty())
+        return Converted<Timespan>{Timespan(seconds)};
+    for (const auto &[name, multiplier] : units) {
+        if (unit != name)
+            continue;
+        if (seconds > std::numeric_limits<double>::max() / multiplier)
+            return Converted<Timespan>::failure(ConversionError::OUT_OF_RANGE);
+        return Converted<Timespan>{Timespan(seconds * multiplier)};
+    }
+    return Converted<Timespan>::failure(ConversionError::INVALID_UNIT);
 }
 
 Timespan::Timespan(double seconds) : _seconds(seconds) {
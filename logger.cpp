@@ -0,0 +1,190 @@
+#include "logger.hpp"
+#include "print.hpp"
+
+#include <iostream>
+#include <cstdint>
+
+#ifdef DEBUG_MODE
+std::atomic<LogLevel> Logger::_level{LogLevel::DEBUG};
+#else
+std::atomic<LogLevel> Logger::_level{LogLevel::INFO};
+#endif
+
+Logger::Logger() : _ring(new Entry[LOGGER_RING_CAPACITY]) {
+    for (size_t i = 0; i < LOGGER_RING_CAPACITY; ++i)
+        _ring[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+/// @brief Stop the writer thread and write everything that is still queued.
+Logger::~Logger() {
+    _stopping.store(true);
+    if (_writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(_wakeMutex);
+            _wake.notify_one();
+        }
+        _writer.join();
+    }
+    flush();
+}
+
+Logger &Logger::instance() {
+    static Logger logger;
+    return (logger);
+}
+
+void Logger::setLevel(LogLevel level) {
+    _level.store(level, std::memory_order_relaxed);
+}
+
+LogLevel Logger::getLevel() {
+    return (_level.load(std::memory_order_relaxed));
+}
+
+/// @brief Parse the name of a log level (debug, info, error or none).
+/// @return False if the name is unknown - the level is not changed then.
+bool Logger::parseLevel(const std::string &name, LogLevel &level) {
+    if (name == "debug") level = LogLevel::DEBUG;
+    else if (name == "info") level = LogLevel::INFO;
+    else if (name == "error") level = LogLevel::ERROR;
+    else if (name == "none") level = LogLevel::NONE;
+    else return (false);
+    return (true);
+}
+
+/// @brief Get the stream of the calling thread to format a message into. The stream is reused, so formatting does not
+/// construct a new stream (and its locale) for every message.
+std::ostringstream &Logger::stream() {
+    thread_local std::ostringstream stream;
+
+    stream.str(std::string());
+    stream.clear();
+    return (stream);
+}
+
+/// @brief Log the message that was formatted into a stream from stream().
+void Logger::write(LogLevel level, std::ostringstream &stream) {
+    std::time_t time = std::time(nullptr);
+    std::string message = std::move(stream).str();
+
+    if (level < LogLevel::ERROR && !_stopping.load(std::memory_order_relaxed)) {
+        std::call_once(_writerStarted, [this]() { _writer = std::thread(&Logger::_run, this); });
+        if (_enqueue(level, time, message)) {
+            _queued.fetch_add(1);
+            if (_writerWaiting.load()) {
+                std::lock_guard<std::mutex> lock(_wakeMutex);
+                _wake.notify_one();
+            }
+            return ;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    _drain();
+    _writeEntry(level, time, message);
+}
+
+/// @brief Write everything that is queued, and flush the streams.
+void Logger::flush() {
+    std::lock_guard<std::mutex> lock(_writeMutex);
+    _drain();
+}
+
+/// @brief Push a message into the ring (a bounded multi-producer queue, where every slot has a sequence number that tells
+/// whether it is free for the position a producer claimed).
+/// @return False if the ring is full.
+bool Logger::_enqueue(LogLevel level, std::time_t time, std::string &message) {
+    size_t position = _enqueuePosition.load(std::memory_order_relaxed);
+    Entry *entry;
+
+    while (true) {
+        entry = &_ring[position % LOGGER_RING_CAPACITY];
+        size_t sequence = entry->sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0) {
+            if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break ;
+        } else if (difference < 0)
+            return (false);
+        else
+            position = _enqueuePosition.load(std::memory_order_relaxed);
+    }
+
+    entry->level = level;
+    entry->time = time;
+    entry->message.swap(message);
+    entry->sequence.store(position + 1, std::memory_order_release);
+    return (true);
+}
+
+/// @brief Write the queued messages in order, until the ring is empty or reaches a slot that is still being filled.
+/// @note Must be called with the write mutex held - whoever holds it is the only consumer of the ring.
+void Logger::_drain() {
+    bool written = false;
+
+    while (true) {
+        Entry &entry = _ring[_dequeuePosition % LOGGER_RING_CAPACITY];
+        if (entry.sequence.load(std::memory_order_acquire) != _dequeuePosition + 1)
+            break ;
+
+        _writeEntry(entry.level, entry.time, entry.message);
+        entry.message.clear();
+        entry.sequence.store(_dequeuePosition + LOGGER_RING_CAPACITY, std::memory_order_release);
+        ++_dequeuePosition;
+        written = true;
+    }
+    if (written)
+        std::cout.flush();
+}
+
+void Logger::_writeEntry(LogLevel level, std::time_t time, const std::string &message) {
+    std::ostream &os = (level >= LogLevel::ERROR) ? std::cerr : std::cout;
+
+    os << _timestamp(time) << message << '\n';
+    if (level >= LogLevel::ERROR)
+        os.flush();
+}
+
+/// @brief Get the formatted timestamp of a time. Only reformatted when the second changes.
+/// @note Must be called with the write mutex held.
+const std::string &Logger::_timestamp(std::time_t time) {
+    if (time == _cachedTime)
+        return (_cachedTimestamp);
+
+    std::tm tm;
+    char buffer[16];
+#if defined(_WIN32) || defined(_WIN64)
+    localtime_s(&tm, &time);
+#else
+    localtime_r(&time, &tm);
+#endif
+    std::strftime(buffer, sizeof(buffer), "%H:%M:%S", &tm);
+
+    _cachedTime = time;
+    _cachedTimestamp = TERM_COLOR_CYAN "[";
+    _cachedTimestamp += buffer;
+    _cachedTimestamp += "] ";
+    return (_cachedTimestamp);
+}
+
+/// @brief Drain the ring in the background, and sleep while it is empty.
+/// A producer counts its message in _queued before it checks _writerWaiting, and the writer sets _writerWaiting before it
+/// checks _queued (both sequentially consistent), so either the writer sees the message or the producer sees the writer
+/// waiting - and then notifies under the wake mutex, which the writer holds from its check until it sleeps.
+void Logger::_run() {
+    while (true) {
+        _queued.store(0);
+        {
+            std::lock_guard<std::mutex> lock(_writeMutex);
+            _drain();
+        }
+        if (_stopping.load())
+            return ;
+
+        std::unique_lock<std::mutex> lock(_wakeMutex);
+        _writerWaiting.store(true);
+        _wake.wait(lock, [this]() { return (_stopping.load() || _queued.load() > 0); });
+        _writerWaiting.store(false);
+    }
+}
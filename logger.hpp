@@ -0,0 +1,81 @@
+#pragma once
+
+#include <condition_variable>
+#include <sstream>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ctime>
+
+#define LOGGER_RING_CAPACITY 4096
+
+enum class LogLevel {
+    DEBUG = 0,
+    INFO = 1,
+    ERROR = 2,
+    NONE = 3,
+};
+
+/// @brief The backend of the logging macros in print.hpp.
+/// Messages are formatted by the calling thread and pushed into a bounded lock-free ring, which a background thread drains
+/// into std::cout / std::cerr - so logging never waits for the terminal. The writer sleeps until a message is queued.
+/// The timestamp is taken when the message is logged, but only formatted by the writer, once per second.
+/// Errors are written synchronously (after everything that was queued before them), so they are never lost and keep their
+/// order with output that is written to the streams directly. When the ring is full, the logging thread writes synchronously too.
+/// @note Messages below the current level are filtered before they are formatted.
+class Logger {
+private:
+    struct Entry {
+        std::atomic<size_t> sequence;
+        LogLevel level;
+        std::time_t time;
+        std::string message;
+    };
+
+    static std::atomic<LogLevel> _level;
+
+    std::unique_ptr<Entry[]> _ring;
+    alignas(64) std::atomic<size_t> _enqueuePosition{0};
+    alignas(64) size_t _dequeuePosition = 0;
+
+    std::mutex _writeMutex;
+    std::time_t _cachedTime = -1;
+    std::string _cachedTimestamp;
+
+    std::mutex _wakeMutex;
+    std::condition_variable _wake;
+    std::atomic<size_t> _queued{0};
+    std::atomic<bool> _writerWaiting{false};
+    std::atomic<bool> _stopping{false};
+    std::thread _writer;
+    std::once_flag _writerStarted;
+
+    Logger();
+
+    bool _enqueue(LogLevel level, std::time_t time, std::string &message);
+    void _drain();
+    void _writeEntry(LogLevel level, std::time_t time, const std::string &message);
+    const std::string &_timestamp(std::time_t time);
+    void _run();
+
+public:
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+    ~Logger();
+
+    static Logger &instance();
+
+    /// @brief Check if messages of a level are written - checked before a message is formatted.
+    inline static bool isEnabled(LogLevel level) { return (level >= _level.load(std::memory_order_relaxed)); }
+    static void setLevel(LogLevel level);
+    static LogLevel getLevel();
+    static bool parseLevel(const std::string &name, LogLevel &level);
+
+    static std::ostringstream &stream();
+
+    void write(LogLevel level, std::ostringstream &stream);
+    void flush();
+};
@@ -1,28 +1,321 @@
 #include "config/rules/ruleTemplates/serverconfigRule.hpp"
 #include "config/rules/objectParser.hpp"
 #include "config/parserExceptions.hpp"
+#include "config/configChecker.hpp"
+#include "config/configManager.hpp"
+#include "config/configWatcher.hpp"
+#include "config/cppEmitter.hpp"
+#include "config/configJson.hpp"
 #include "config/config.hpp"
 #include "print.hpp"
 
-int main(int argc, char **argv) {
-    if (argc > 2) {
-        ERROR("Too many arguments provided.");
+#include <csignal>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define STRESS_LOOKUPS_PER_THREAD 200000
+#define STRESS_RELOADS 100
+
+static void printUsage() {
+    std::cerr << "Usage: parser [--log-level=L] [--format=text|json|ast-json] [file]\n"
+              << "       parser [--log-level=L] --stress=N [file]\n"
+              << "       parser [--log-level=L] --watch [file]\n"
+              << "       parser [--log-level=L] --emit-cpp [file] > config.hpp\n"
+              << "       parser --check-all [--jobs=N] <file|directory|->...\n"
+              << "  --check-all   Validate every file (directories are searched for .conf files, - reads paths from stdin)\n"
+              << "                and print one JSON object per file, followed by a summary.\n"
+              << "  --jobs=N      Check N files at the same time (default: one per core).\n"
+              << "  --format=F    Print the servers as text (default), as JSON, or print the parsed tree as JSON (ast-json).\n"
+              << "  --emit-cpp    Print the servers as a C++ header of constexpr tables with generated routing functions.\n"
+              << "  --stress=N    Look up routes, locations and error pages of one configuration from N threads at once.\n"
+              << "  --watch       Keep the configuration loaded and reload it whenever one of its files changes, until interrupted.\n"
+              << "  --log-level=L Only log messages of level L or above: debug, info, error or none.\n"
+              << "                Debug messages are only compiled into debug builds (make dbrun), other builds reject debug.\n";
+}
+
+/// @brief Validate many files on a thread pool and print the results as JSON lines.
+/// @return 0 if every file is valid, 1 otherwise.
+static int checkAll(const std::vector<std::string> &arguments) {
+    std::vector<std::string> paths;
+    size_t jobs = 0;
+
+    for (const std::string &argument : arguments) {
+        if (argument.rfind("--jobs=", 0) == 0) {
+            Converted<size_t> jobCount = parseInteger<size_t>(std::string_view(argument).substr(7));
+            if (!jobCount) {
+                ERROR("Invalid job count '" << argument.substr(7) << "': " << getConversionErrorReason(jobCount.error));
+                return (1);
+            }
+            jobs = jobCount.value;
+        } else if (argument == "-") {
+            for (std::string line; std::getline(std::cin, line); )
+                if (!line.empty())
+                    paths.push_back(line);
+        } else
+            paths.push_back(argument);
+    }
+
+    std::vector<std::string> files = ConfigChecker::collectFiles(paths);
+    if (files.empty()) {
+        ERROR("No configuration files to check.");
+        return (1);
+    }
+
+    ConfigChecker checker(jobs);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<CheckResult> results = checker.checkAll(files);
+    double totalMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    JsonWriter json;
+    size_t passed = 0;
+    for (const CheckResult &result : results) {
+        passed += result.passed;
+        json.beginObject();
+        json.key("file").string(result.filePath);
+        json.key("status").string(result.passed ? "pass" : "fail");
+        json.key("servers").number(result.serverCount);
+        json.key("parse_ms").number(result.parseMilliseconds);
+        json.key("build_ms").number(result.buildMilliseconds);
+        json.key("errors").beginArray();
+        for (const CheckError &error : result.errors) {
+            json.beginObject();
+            json.key("message").string(error.message);
+            if (error.location.empty())
+                json.key("location").null();
+            else
+                json.key("location").string(error.location);
+            json.key("traceback").beginArray();
+            for (const std::string &include : error.traceback)
+                json.string(include);
+            json.endArray();
+            json.endObject();
+        }
+        json.endArray();
+        json.endObject();
+        json.newline();
+    }
+    json.beginObject();
+    json.key("summary").boolean(true);
+    json.key("files").number(results.size());
+    json.key("passed").number(passed);
+    json.key("failed").number(results.size() - passed);
+    json.key("threads").number(checker.getThreadCount());
+    json.key("total_ms").number(totalMilliseconds);
+    json.endObject();
+    json.newline();
+    std::cout << json << std::flush;
+
+    return (passed == results.size() ? 0 : 1);
+}
+
+/// @brief Share one configuration between threads that do nothing but lookups: routing, location rules, error pages,
+/// CGI matching and path mapping. Every lookup reads the active snapshot of a ConfigManager, while the main thread keeps
+/// reloading it. Measures the lookup throughput, and gives ThreadSanitizer (make tsan) something to check.
+/// @return 0 when every thread finished, 1 if the configuration could not be loaded.
+static int stress(const std::string &filePath, size_t threadCount) {
+    ConfigManager manager(filePath);
+    if (!manager.reload())
+        return (1);
+
+    std::vector<std::string> urls = {"/", "/does/not/exist?query=1", "/../escape"};
+    for (const std::shared_ptr<const ServerConfig> &server : manager.getSnapshot()->servers) {
+        for (const LocationRule &location : server->getLocations()) {
+            if (location.modifier == LocationModifier::REGEX_MATCH)
+                continue;
+            urls.push_back(location.path.str());
+            urls.push_back(location.path.str() + "/index.html");
+            urls.push_back(location.path.str() + "/script.py?x=1");
+        }
+    }
+
+    std::atomic<size_t> checksum = 0;
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&manager, &urls, &checksum, t]() {
+            char buffer[4096];
+            size_t sum = 0;
+
+            for (size_t i = 0; i < STRESS_LOOKUPS_PER_THREAD; ++i) {
+                const std::vector<std::shared_ptr<const ServerConfig>> &servers = manager.getSnapshot()->servers;
+                const ServerConfig &server = *servers[i % servers.size()];
+                const std::string &url = urls[(i * 7 + t) % urls.size()];
+                size_t pathLength = Path::normalizeUrl(url, std::span<char>(buffer, sizeof(buffer)));
+                if (pathLength == std::string::npos)
+                    continue;
+                std::string_view path(buffer, pathLength);
+                const LocationRoute &route = server.getRoute(path);
+                const LocationRule &location = server.getLocation(route);
+
+                sum += route.prefix.length() + location.cold().errorPages.getErrorPage(StatusCode(404)).length();
+                sum += (location.cold().errorPages.getErrorResponse(StatusCode(500)) != nullptr);
+                sum += location.cold().cgiExtention.isCGI(location.root.getRootPath());
+                sum += location.root.getRootPath().getFilename().length();
+
+                size_t length = Path::createFromPath(path, location, std::span<char>(buffer, sizeof(buffer)));
+                if (length != std::string::npos)
+                    sum += length;
+            }
+            checksum += sum;
+        });
+    }
+    for (size_t i = 0; i < STRESS_RELOADS; ++i)
+        manager.reload();
+    for (std::thread &thread : threads)
+        thread.join();
+
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    size_t lookups = threadCount * STRESS_LOOKUPS_PER_THREAD;
+    std::cout << threadCount << " threads, " << lookups << " lookups in " << milliseconds << " ms ("
+              << static_cast<size_t>(lookups / (milliseconds / 1000)) << " lookups/s, checksum " << checksum << ")" << std::endl;
+    return (0);
+}
+
+#ifdef __linux__
+/// @brief Keep a configuration loaded, and reload it whenever one of its files changes - until SIGINT or SIGTERM.
+/// @return 0 when interrupted, 1 if the configuration could not be loaded or watched.
+static int watch(const std::string &filePath) {
+    sigset_t signals;
+    int signal;
+
+    // Blocked before the threads of the manager and the watcher start, so they inherit the mask and sigwait() gets the signal.
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    ConfigManager manager(filePath);
+    if (!manager.reload())
+        return (1);
+    size_t listener = manager.addPublishListener([&filePath](const ConfigSnapshot &snapshot) {
+        PRINT("Reloaded " << filePath << ": configuration generation " << snapshot.generation << " with "
+            << snapshot.servers.size() << " servers.");
+    });
+    ConfigWatcher watcher(manager);
+    if (!watcher.start())
         return (1);
+
+    PRINT("Watching " << filePath << " (configuration generation " << manager.getGeneration() << "), stop with Ctrl-C.");
+    sigwait(&signals, &signal);
+    watcher.stop();
+    manager.removePublishListener(listener);
+    PRINT("Stopped watching " << filePath << " at configuration generation " << manager.getGeneration() << ".");
+    return (0);
+}
+#endif
+
+/// @brief How the configuration is printed.
+enum OutputFormat {
+    TEXT_FORMAT,
+    JSON_FORMAT,
+    AST_JSON_FORMAT,
+    CPP_FORMAT,
+};
+
+int main(int argc, char **argv) {
+    std::vector<std::string> arguments;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument.rfind("--log-level=", 0) != 0) {
+            arguments.push_back(argument);
+            continue;
+        }
+        LogLevel level;
+        if (!Logger::parseLevel(argument.substr(12), level)) {
+            ERROR("Invalid log level '" << argument.substr(12) << "'.");
+            printUsage();
+            return (1);
+        }
+#ifndef DEBUG_MODE
+        if (level == LogLevel::DEBUG) {
+            ERROR("Log level 'debug' is not available: this build has no debug messages, build it with 'make dbrun'.");
+            return (1);
+        }
+#endif
+        Logger::setLevel(level);
     }
 
+    if (!arguments.empty() && arguments[0] == "--check-all")
+        return (checkAll(std::vector<std::string>(arguments.begin() + 1, arguments.end())));
+
     std::string filePath = "default.conf";
-    if (argc == 2) filePath = argv[1];
+    OutputFormat format = TEXT_FORMAT;
+    size_t stressThreads = 0;
+    bool watchFile = false;
+    bool hasFilePath = false;
+    for (const std::string &argument : arguments) {
+        if (argument.rfind("--stress=", 0) == 0) {
+            Converted<size_t> threadCount = parseInteger<size_t>(std::string_view(argument).substr(9));
+            if (!threadCount || threadCount.value == 0) {
+                ERROR("Invalid thread count '" << argument.substr(9) << "'.");
+                return (1);
+            }
+            stressThreads = threadCount.value;
+        } else if (argument == "--watch")
+            watchFile = true;
+        else if (argument == "--format=text")
+            format = TEXT_FORMAT;
+        else if (argument == "--format=json")
+            format = JSON_FORMAT;
+        else if (argument == "--format=ast-json")
+            format = AST_JSON_FORMAT;
+        else if (argument == "--emit-cpp")
+            format = CPP_FORMAT;
+        else if (argument.rfind("--", 0) != 0 && !hasFilePath) {
+            filePath = argument;
+            hasFilePath = true;
+        } else {
+            ERROR("Invalid arguments provided.");
+            printUsage();
+            return (1);
+        }
+    }
+
+    if (stressThreads)
+        return (stress(filePath, stressThreads));
+    if (watchFile) {
+#ifdef __linux__
+        return (watch(filePath));
+#else
+        ERROR("--watch needs inotify, which is only available on Linux.");
+        return (1);
+#endif
+    }
 
     ConfigurationParser* parser = new ConfigurationParser();
     parser->parseFile(filePath);
     std::vector<ServerConfig> servers = parser->getResult(filePath);
-    delete parser;
 
-    if (servers.empty())
+    if (servers.empty()) {
+        delete parser;
         exit(1);
+    }
 
-    for (const auto &server : servers)
-        std::cout << server << std::endl;
+    if (format == CPP_FORMAT) {
+        emitCpp(std::cout, servers, filePath);
+        std::cout << std::flush;
+    } else if (format == AST_JSON_FORMAT) {
+        JsonWriter json;
+        writeJson(json, *parser->getObject(filePath));
+        json.newline();
+        std::cout << json << std::flush;
+    } else if (format == JSON_FORMAT) {
+        JsonWriter json;
+        json.beginArray();
+        for (const auto &server : servers)
+            writeJson(json, server);
+        json.endArray();
+        json.newline();
+        std::cout << json << std::flush;
+    } else {
+        for (const auto &server : servers)
+            std::cout << server << std::endl;
+    }
+    delete parser;
 
     return (0);
 }
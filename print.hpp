@@ -1,9 +1,9 @@
 #pragma once
 
+#include "logger.hpp"
+
 #include <iostream>
-#include <iomanip>
-#include <chrono>
-#include <ctime>
+#include <sstream>
 
 #define TERM_COLOR_RESET "\033[0m"
 #define TERM_COLOR_RED "\033[31m"
@@ -16,70 +16,46 @@
 #define TERM_BOLD "\033[1m"
 #define TERM_UNDERLINE "\033[4m"
 
-inline std::ostream& print_time(std::ostream& os) {
-    auto now = std::chrono::system_clock::now();
-    std::time_t t = std::chrono::system_clock::to_time_t(now);
-    std::tm tm;
-#if defined(_WIN32) || defined(_WIN64)
-    localtime_s(&tm, &t);
-#else
-    localtime_r(&t, &tm);
-#endif
-    return os << TERM_COLOR_CYAN << "[" << std::put_time(&tm, "%H:%M:%S") << "] ";
-}
-
-#define PRINT(x) do { \
-    print_time(std::cout); \
-    std::cout << TERM_COLOR_BLUE << x << TERM_COLOR_RESET << std::endl; \
+/// @brief Format a message and hand it to the logger, if its level is enabled. See logger.hpp.
+#define LOG_MESSAGE(level, x) do { \
+    if (Logger::isEnabled(level)) { \
+        std::ostringstream &logStream = Logger::stream(); \
+        logStream << x; \
+        Logger::instance().write(level, logStream); \
+    } \
 } while (0)
+
+#define PRINT(x) LOG_MESSAGE(LogLevel::INFO, TERM_COLOR_BLUE << x << TERM_COLOR_RESET)
 #define PRINT_IF(cond, x) do { \
-    if (cond) { \
-        print_time(std::cout); \
-        std::cout << TERM_COLOR_YELLOW << "[COND: " #cond "] " << TERM_COLOR_BLUE << x << TERM_COLOR_RESET << std::endl; \
-    } \
+    if (cond) \
+        LOG_MESSAGE(LogLevel::INFO, TERM_COLOR_YELLOW << "[COND: " #cond "] " << TERM_COLOR_BLUE << x << TERM_COLOR_RESET); \
 } while (0)
 #define PRINT_IF_NOT(cond, x) do { \
-    if (!(cond)) { \
-        print_time(std::cout); \
-        std::cout << TERM_COLOR_YELLOW << "[COND: !" #cond "] " TERM_COLOR_BLUE << x << TERM_COLOR_RESET << std::endl; \
-    } \
-} while (0)
-#define ERROR(x) do { \
-    print_time(std::cerr); \
-    std::cerr << TERM_COLOR_RED << "[ERROR] " << TERM_COLOR_RESET << x << std::endl; \
+    if (!(cond)) \
+        LOG_MESSAGE(LogLevel::INFO, TERM_COLOR_YELLOW << "[COND: !" #cond "] " TERM_COLOR_BLUE << x << TERM_COLOR_RESET); \
 } while (0)
+#define ERROR(x) LOG_MESSAGE(LogLevel::ERROR, TERM_COLOR_RED << "[ERROR] " << TERM_COLOR_RESET << x)
 #define ERROR_IF(cond, x) do { \
-    if (cond) { \
-        print_time(std::cerr); \
-        std::cerr << TERM_COLOR_RED << "[ERROR] " << TERM_COLOR_YELLOW << "[COND: " #cond "] " << TERM_COLOR_RESET << x << std::endl; \
-    } \
+    if (cond) \
+        LOG_MESSAGE(LogLevel::ERROR, TERM_COLOR_RED << "[ERROR] " << TERM_COLOR_YELLOW << "[COND: " #cond "] " << TERM_COLOR_RESET << x); \
 } while (0)
 #define ERROR_IF_NOT(cond, x) do { \
-    if (!(cond)) { \
-        print_time(std::cerr); \
-        std::cerr << TERM_COLOR_RED << "[ERROR] " << TERM_COLOR_YELLOW << "[COND: !" #cond "] " << TERM_COLOR_RESET << x << std::endl; \
-    } \
+    if (!(cond)) \
+        LOG_MESSAGE(LogLevel::ERROR, TERM_COLOR_RED << "[ERROR] " << TERM_COLOR_YELLOW << "[COND: !" #cond "] " << TERM_COLOR_RESET << x); \
 } while (0)
 
 #ifdef DEBUG_MODE
-# define DEBUG(x) do { \
-    print_time(std::cout); \
-    std::cout << TERM_COLOR_GREEN << "[DEBUG] " << TERM_COLOR_RESET << x << std::endl; \
-} while (0)
+# define DEBUG(x) LOG_MESSAGE(LogLevel::DEBUG, TERM_COLOR_GREEN << "[DEBUG] " << TERM_COLOR_RESET << x)
 # define DEBUG_IF(cond, x) do { \
-    if (cond) { \
-        print_time(std::cout); \
-        std::cout << TERM_COLOR_GREEN << "[DEBUG] " << TERM_COLOR_YELLOW << "[COND: " #cond "] " << TERM_COLOR_RESET << x << std::endl; \
-    } \
+    if (cond) \
+        LOG_MESSAGE(LogLevel::DEBUG, TERM_COLOR_GREEN << "[DEBUG] " << TERM_COLOR_YELLOW << "[COND: " #cond "] " << TERM_COLOR_RESET << x); \
 } while (0)
 # define DEBUG_IF_NOT(cond, x) do { \
-    if (!(cond)) { \
-        print_time(std::cout); \
-        std::cout << TERM_COLOR_GREEN << "[DEBUG] " << TERM_COLOR_YELLOW << "[COND: " #cond "] " << TERM_COLOR_RESET << x << std::endl; \
-    } \
+    if (!(cond)) \
+        LOG_MESSAGE(LogLevel::DEBUG, TERM_COLOR_GREEN << "[DEBUG] " << TERM_COLOR_YELLOW << "[COND: !" #cond "] " << TERM_COLOR_RESET << x); \
 } while (0)
 #else
 # define DEBUG(x) do {} while (0)
 # define DEBUG_IF(cond, x) do {} while (0)
 # define DEBUG_IF_NOT(cond, x) do {} while (0)
-#endif
\ No newline at end of file
+#endif
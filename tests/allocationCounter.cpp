@@ -0,0 +1,67 @@
+#include "allocationCounter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+static thread_local size_t allocations = 0;
+
+static void *allocate(size_t size, size_t alignment) {
+    void *memory;
+
+    ++allocations;
+    if (size == 0)
+        size = 1;
+    if (alignment <= alignof(std::max_align_t))
+        memory = std::malloc(size);
+    else
+        memory = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    return (memory);
+}
+
+void *operator new(size_t size) {
+    if (void *memory = allocate(size, 0))
+        return (memory);
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) {
+    return (operator new(size));
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    if (void *memory = allocate(size, static_cast<size_t>(alignment)))
+        return (memory);
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size, std::align_val_t alignment) {
+    return (operator new(size, alignment));
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    return (allocate(size, 0));
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    return (allocate(size, 0));
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, size_t, std::align_val_t) noexcept { std::free(memory); }
+
+AllocationCounter::AllocationCounter() : _start(allocations) {}
+
+/// @brief Get the number of allocations of the calling thread since the counter was created or reset.
+size_t AllocationCounter::count() const {
+    return (allocations - _start);
+}
+
+void AllocationCounter::reset() {
+    _start = allocations;
+}
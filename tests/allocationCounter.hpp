@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+
+/// @brief Counts the heap allocations of the calling thread since it was created. The global operator new is replaced
+/// by a counting version in allocationCounter.cpp, which is only linked into the test programs.
+class AllocationCounter {
+private:
+    size_t _start;
+
+public:
+    AllocationCounter();
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+    ~AllocationCounter() = default;
+
+    size_t count() const;
+    void reset();
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+
+/// @brief Measures the wall-clock time since it was created.
+class BenchmarkTimer {
+private:
+    std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+
+public:
+    double seconds() const {
+        return (std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count());
+    }
+};
+
+/// @brief Print one measurement of a benchmark.
+#define BENCHMARK_REPORT(name, value, unit) (std::cout << "[BENCH] " << (name) << ": " << (value) << " " << (unit) << std::endl)
@@ -0,0 +1,103 @@
+#include "../config/configChecker.hpp"
+#include "../config/diagnostics.hpp"
+#include "test.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+/// @brief An error in an included file points at the offending token in that file, and carries the include rule that led there.
+static void testErrorLocation(ConfigChecker &checker, const std::string &directory) {
+    std::string mainPath = directory + "/main.conf";
+    std::string badPath = directory + "/bad.conf";
+    std::ofstream(badPath) << "server {\n    listen 8080;\n    server_name bad;\n    unknown_rule on;\n}\n";
+    std::ofstream(mainPath) << "# main\ninclude " << badPath << ";\n";
+
+    std::vector<CheckResult> results = checker.checkAll({mainPath});
+    CHECK(results.size() == 1 && !results[0].passed);
+    if (results.size() != 1 || results[0].errors.empty())
+        return ;
+
+    const CheckError &error = results[0].errors[0];
+    CHECK(!error.message.empty());
+    CHECK(error.location == badPath + ":4:5");
+    CHECK(error.traceback.size() == 1);
+    if (error.traceback.size() == 1)
+        CHECK(error.traceback[0] == mainPath + ":2: include " + badPath + ";");
+}
+
+/// @brief Errors that do not come from a token, like a file that cannot be opened, have no location.
+static void testErrorWithoutLocation(ConfigChecker &checker, const std::string &directory) {
+    std::vector<CheckResult> results = checker.checkAll({directory + "/missing.conf"});
+    CHECK(results.size() == 1 && results[0].errors.size() == 1);
+    if (results.size() == 1 && results[0].errors.size() == 1) {
+        CHECK(results[0].errors[0].location.empty());
+        CHECK(results[0].errors[0].traceback.empty());
+    }
+}
+
+/// @brief An invalid value that was set through a variable is longer than its ${name} reference: the error points at the
+/// reference in the file, and its context is printed without reading past the end of the line.
+static void testExpandedValueError(ConfigChecker &checker, const std::string &directory) {
+    std::string filePath = directory + "/variable.conf";
+    std::ofstream(filePath) << "server {\n    listen 8080;\n    server_name a;\n    set $s abcdefghijklmnop;\n"
+        "    client_max_body_size ${s};\n}\n";
+
+    std::vector<CheckResult> results = checker.checkAll({filePath});
+    CHECK(results.size() == 1 && results[0].errors.size() == 1);
+    if (results.size() == 1 && results[0].errors.size() == 1)
+        CHECK(results[0].errors[0].location == filePath + ":5:26");
+
+    DiagnosticSink diagnostics;
+    ConfigurationParser parser(LoadMode::IN_MEMORY, &diagnostics);
+    if (parser.parseFile(filePath))
+        parser.getResult(filePath);
+    CHECK(diagnostics.size() == 1);
+
+    std::ostringstream output;
+    try {
+        diagnostics.print(output);
+    } catch (const std::exception &e) {
+        CHECK(!"printing the diagnostic throws");
+    }
+    CHECK(output.str().find("${s}") != std::string::npos);
+}
+
+/// @brief A cached error page that does not exist fails the check at its error_page rule, without the cache it is read later.
+static void testMissingCachedErrorPage(ConfigChecker &checker, const std::string &directory) {
+    std::string cachedPath = directory + "/cached.conf";
+    std::string uncachedPath = directory + "/uncached.conf";
+    std::string pagePath = directory + "/missing.html";
+    std::string server = "server {\n    listen 8080;\n    server_name a;\n    error_page 404 " + pagePath + ";\n";
+    std::ofstream(cachedPath) << server << "    error_page_cache on;\n}\n";
+    std::ofstream(uncachedPath) << server << "}\n";
+
+    std::vector<CheckResult> results = checker.checkAll({cachedPath, uncachedPath});
+    CHECK(results.size() == 2);
+    if (results.size() != 2)
+        return ;
+    CHECK(!results[0].passed && results[0].errors.size() == 1);
+    if (results[0].errors.size() == 1)
+        CHECK(results[0].errors[0].location == cachedPath + ":4:20");
+    CHECK(results[1].passed);
+
+    std::ofstream(pagePath) << "<h1>Not found</h1>";
+    results = checker.checkAll({cachedPath});
+    CHECK(results.size() == 1 && results[0].passed);
+}
+
+int main() {
+    Logger::setLevel(LogLevel::NONE);
+    char directory[] = "/tmp/configCheckerTest.XXXXXX";
+    if (!mkdtemp(directory))
+        return (1);
+
+    ConfigChecker checker(2);
+    testErrorLocation(checker, directory);
+    testErrorWithoutLocation(checker, directory);
+    testExpandedValueError(checker, directory);
+    testMissingCachedErrorPage(checker, directory);
+    std::filesystem::remove_all(directory);
+    return (TEST_RESULT("configCheckerTest"));
+}
@@ -0,0 +1,162 @@
+#include "../config/configManager.hpp"
+#include "test.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <cstdlib>
+
+/// @brief Write a server block that listens on a port.
+static void writeServer(const std::string &filePath, int port, const std::string &extra = "") {
+    std::ofstream file(filePath, std::ios::trunc);
+    file << "server {\n    listen " << port << ";\n    server_name test" << port << ";\n" << extra << "}\n";
+}
+
+static int portOf(const ConfigSnapshot &snapshot, size_t server) {
+    return (snapshot.servers[server]->port.getPort().value);
+}
+
+/// @brief Reload a configuration of two included servers: an unchanged configuration keeps its snapshot, a changed file
+/// only rebuilds the servers that depend on it, and an invalid configuration keeps the previous generation active.
+static void testReload(const std::string &directory) {
+    std::string mainPath = directory + "/main.conf";
+    std::ofstream(mainPath) << "include " << directory << "/a.conf;\ninclude " << directory << "/b.conf;\n";
+    writeServer(directory + "/a.conf", 8081);
+    writeServer(directory + "/b.conf", 8082);
+
+    ConfigManager manager(mainPath);
+    CHECK(manager.getSnapshot() == nullptr);
+    CHECK(manager.getGeneration() == 0);
+
+    CHECK(manager.reload());
+    std::shared_ptr<const ConfigSnapshot> first = manager.getSnapshot();
+    CHECK(first && first->generation == 1 && first->servers.size() == 2);
+    if (!first || first->servers.size() != 2)
+        return ;
+    CHECK(portOf(*first, 0) == 8081 && portOf(*first, 1) == 8082);
+
+    CHECK(manager.reload());
+    CHECK(manager.getSnapshot() == first);
+    CHECK(manager.getGeneration() == 1);
+
+    writeServer(directory + "/b.conf", 9082, "    root var/www;\n");
+    CHECK(manager.reload());
+    std::shared_ptr<const ConfigSnapshot> second = manager.getSnapshot();
+    CHECK(second != first && second->generation == 2 && second->servers.size() == 2);
+    if (second->servers.size() == 2) {
+        CHECK(second->servers[0] == first->servers[0]);
+        CHECK(second->servers[1] != first->servers[1]);
+        CHECK(portOf(*second, 1) == 9082);
+    }
+    CHECK(portOf(*first, 1) == 8082);
+
+    // The errors of an invalid configuration go through the logger, which is silenced by the test.
+    writeServer(directory + "/a.conf", 8081, "    listen;\n");
+    std::ostringstream errors;
+    std::streambuf *stderrBuffer = std::cerr.rdbuf(errors.rdbuf());
+    CHECK(!manager.reload());
+    std::cerr.rdbuf(stderrBuffer);
+    CHECK(errors.str().empty());
+    CHECK(manager.getSnapshot() == second);
+    CHECK(manager.getGeneration() == 2);
+}
+
+/// @brief A file that is added to or removed from the directory of a glob include changes the configuration, even though
+/// none of the files that were loaded changed.
+static void testIncludePattern(const std::string &directory) {
+    std::string mainPath = directory + "/tenants.conf";
+    std::filesystem::create_directory(directory + "/conf.d");
+    std::ofstream(mainPath) << "include " << directory << "/conf.d/*.conf;\n";
+    writeServer(directory + "/conf.d/a.conf", 8081);
+
+    ConfigManager manager(mainPath);
+    CHECK(manager.reload());
+    CHECK(manager.getSnapshot()->servers.size() == 1);
+
+    writeServer(directory + "/conf.d/b.conf", 8082);
+    CHECK(manager.reload());
+    std::shared_ptr<const ConfigSnapshot> added = manager.getSnapshot();
+    CHECK(added->generation == 2 && added->servers.size() == 2);
+    if (added->servers.size() == 2)
+        CHECK(portOf(*added, 1) == 8082);
+
+    std::filesystem::remove(directory + "/conf.d/a.conf");
+    CHECK(manager.reload());
+    std::shared_ptr<const ConfigSnapshot> removed = manager.getSnapshot();
+    CHECK(removed->generation == 3 && removed->servers.size() == 1);
+    if (removed->servers.size() == 1)
+        CHECK(portOf(*removed, 0) == 8082);
+}
+
+/// @brief Get the preloaded body of the 404 response of the default location of the first server.
+static std::string notFoundBody(const ConfigSnapshot &snapshot) {
+    const ErrorResponse *response = snapshot.servers[0]->getDefaultLocation().cold().errorPages.getErrorResponse(StatusCode(404));
+    return (response ? response->body : "");
+}
+
+/// @brief A cached error page is part of the configuration: changing only the page reloads the server that preloaded it.
+static void testErrorPageReload(const std::string &directory) {
+    std::string mainPath = directory + "/pages.conf";
+    std::string pagePath = directory + "/404.html";
+    std::ofstream(pagePath) << "first";
+    writeServer(mainPath, 8095, "    error_page 404 " + pagePath + ";\n    error_page_cache on;\n");
+
+    ConfigManager manager(mainPath);
+    CHECK(manager.reload());
+    std::shared_ptr<const ConfigSnapshot> first = manager.getSnapshot();
+    CHECK(first->files.count(pagePath) == 1);
+    CHECK(notFoundBody(*first) == "first");
+
+    std::ofstream(pagePath, std::ios::trunc) << "second page";
+    CHECK(manager.reload());
+    std::shared_ptr<const ConfigSnapshot> second = manager.getSnapshot();
+    CHECK(second->generation == 2 && second->servers[0] != first->servers[0]);
+    CHECK(notFoundBody(*second) == "second page");
+    CHECK(notFoundBody(*first) == "first");
+
+    CHECK(manager.reload());
+    CHECK(manager.getGeneration() == 2);
+}
+
+/// @brief A thread that cached a snapshot gets the new one once a reload is published.
+static void testThreadCache(const std::string &directory) {
+    std::string mainPath = directory + "/single.conf";
+    writeServer(mainPath, 8090);
+
+    ConfigManager manager(mainPath);
+    CHECK(manager.reload());
+
+    std::shared_ptr<const ConfigSnapshot> seen;
+    std::thread([&manager, &seen]() {
+        seen = manager.getSnapshot();
+        CHECK(manager.getSnapshot() == seen);
+    }).join();
+    CHECK(seen == manager.getSnapshot());
+
+    writeServer(mainPath, 8091, "    root var/www;\n");
+    CHECK(manager.reload());
+    std::thread([&manager, &seen]() {
+        CHECK(manager.getSnapshot() != seen);
+        CHECK(manager.getSnapshot()->generation == 2 && portOf(*manager.getSnapshot(), 0) == 8091);
+    }).join();
+
+    // Reading another manager on the same thread does not return the snapshot of the first one.
+    ConfigManager other(directory + "/main.conf");
+    CHECK(other.getSnapshot() == nullptr);
+    CHECK(manager.getSnapshot()->generation == 2);
+}
+
+int main() {
+    Logger::setLevel(LogLevel::NONE);
+    char directory[] = "/tmp/configManagerTest.XXXXXX";
+    if (!mkdtemp(directory))
+        return (1);
+
+    testReload(directory);
+    testThreadCache(directory);
+    testIncludePattern(directory);
+    testErrorPageReload(directory);
+    std::filesystem::remove_all(directory);
+    return (TEST_RESULT("configManagerTest"));
+}
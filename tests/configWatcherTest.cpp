@@ -0,0 +1,98 @@
+#include "../config/configWatcher.hpp"
+#include "test.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <cstdlib>
+
+#define WATCHER_TEST_DEBOUNCE std::chrono::milliseconds(50)
+#define WATCHER_TEST_TIMEOUT std::chrono::seconds(5)
+
+#ifdef __linux__
+
+/// @brief Write a server block that listens on a port.
+static void writeServer(const std::string &filePath, int port) {
+    std::ofstream file(filePath, std::ios::trunc);
+    file << "server {\n    listen " << port << ";\n    server_name test" << port << ";\n}\n";
+}
+
+/// @brief Wait until the manager published a generation, or the timeout expired.
+static bool waitForGeneration(const ConfigManager &manager, uint64_t generation) {
+    auto deadline = std::chrono::steady_clock::now() + WATCHER_TEST_TIMEOUT;
+
+    while (manager.getGeneration() < generation && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(WATCHER_TEST_DEBOUNCE);
+    return (manager.getGeneration() >= generation);
+}
+
+/// @brief A configuration that is published by another thread than the watcher adds a new directory: the watcher picks it
+/// up right away, even though none of the watched files changed since it started, so a later change of a file in that
+/// directory reloads the configuration.
+static void testWatchesFollowPublishedConfiguration(const std::string &directory) {
+    std::string mainPath = directory + "/main.conf";
+    writeServer(directory + "/a.conf", 8081);
+    std::ofstream(mainPath) << "include " << directory << "/a.conf;\n";
+
+    ConfigManager manager(mainPath);
+    CHECK(manager.reload());
+
+    std::filesystem::create_directory(directory + "/sites");
+    writeServer(directory + "/sites/b.conf", 8082);
+    std::ofstream(mainPath, std::ios::trunc) << "include " << directory << "/a.conf;\ninclude " << directory << "/sites/b.conf;\n";
+
+    ConfigWatcher watcher(manager, WATCHER_TEST_DEBOUNCE);
+    CHECK(watcher.start());
+    CHECK(manager.reload());
+    CHECK(manager.getGeneration() == 2);
+
+    // The publish listener wakes up the watcher, which then watches the new directory.
+    std::this_thread::sleep_for(WATCHER_TEST_DEBOUNCE * 4);
+    writeServer(directory + "/sites/b.conf", 9082);
+    CHECK(waitForGeneration(manager, 3));
+    if (manager.getGeneration() >= 3) {
+        std::shared_ptr<const ConfigSnapshot> snapshot = manager.getSnapshot();
+        CHECK(snapshot->servers.size() == 2 && snapshot->servers[1]->port.getPort().value == 9082);
+    }
+    watcher.stop();
+}
+
+/// @brief A file that is created in the directory of a glob include reloads the configuration, a file that the pattern
+/// does not match does not.
+static void testWatchesIncludePattern(const std::string &directory) {
+    std::string mainPath = directory + "/tenants.conf";
+    std::filesystem::create_directory(directory + "/conf.d");
+    std::ofstream(mainPath) << "include " << directory << "/conf.d/*.conf;\n";
+    writeServer(directory + "/conf.d/a.conf", 8081);
+
+    ConfigManager manager(mainPath);
+    CHECK(manager.reload());
+    ConfigWatcher watcher(manager, WATCHER_TEST_DEBOUNCE);
+    CHECK(watcher.start());
+
+    std::ofstream(directory + "/conf.d/notes.txt") << "not included\n";
+    std::this_thread::sleep_for(WATCHER_TEST_DEBOUNCE * 4);
+    CHECK(manager.getGeneration() == 1);
+
+    writeServer(directory + "/conf.d/b.conf", 8082);
+    CHECK(waitForGeneration(manager, 2));
+    if (manager.getGeneration() >= 2)
+        CHECK(manager.getSnapshot()->servers.size() == 2);
+    watcher.stop();
+}
+
+#endif
+
+int main() {
+    Logger::setLevel(LogLevel::NONE);
+#ifdef __linux__
+    char directory[] = "/tmp/configWatcherTest.XXXXXX";
+    if (!mkdtemp(directory))
+        return (1);
+
+    testWatchesFollowPublishedConfiguration(directory);
+    testWatchesIncludePattern(directory);
+    std::filesystem::remove_all(directory);
+#endif
+    return (TEST_RESULT("configWatcherTest"));
+}
@@ -0,0 +1,57 @@
+#include "../config/parserExceptions.hpp"
+#include "benchmark.hpp"
+#include "test.hpp"
+
+#define EXCEPTION_BENCHMARK_ITERATIONS 100000
+
+/// @brief Find the first argument of the first error_page rule of the first server - default.conf includes its
+/// error pages through a define, so the error of this argument has a traceback.
+static const Argument *findIncludedArgument(const ConfigurationParser &parser) {
+    const Rules &servers = parser.getServerRules("default.conf");
+    if (servers.empty() || servers[0]->arguments.empty() || !servers[0]->arguments[0]->getObject())
+        return (nullptr);
+
+    const Object *server = servers[0]->arguments[0]->getObject();
+    auto errorPages = server->rules.find(Key::ERROR_PAGE);
+    if (errorPages == server->rules.end() || errorPages->second.empty() || errorPages->second[0]->arguments.empty())
+        return (nullptr);
+    return (errorPages->second[0]->arguments[0]);
+}
+
+/// @brief Throw and catch argument errors, with and without rendering their message.
+/// Exceptions that are caught and discarded (e.g. while validating) must not pay for the traceback.
+int main() {
+    Logger::setLevel(LogLevel::ERROR);
+    ConfigurationParser parser;
+    if (!parser.parseFile("default.conf"))
+        return (1);
+    const Argument *argument = findIncludedArgument(parser);
+    if (!argument)
+        return (1);
+
+    size_t caught = 0;
+    BenchmarkTimer discardTimer;
+    for (size_t i = 0; i < EXCEPTION_BENCHMARK_ITERATIONS; ++i) {
+        try {
+            throw ParserArgumentException("Expected a valid error code", argument, "Check the argument type.");
+        } catch (const ParserException &) {
+            ++caught;
+        }
+    }
+    double discardSeconds = discardTimer.seconds();
+
+    size_t rendered = 0;
+    BenchmarkTimer renderTimer;
+    for (size_t i = 0; i < EXCEPTION_BENCHMARK_ITERATIONS; ++i) {
+        try {
+            throw ParserArgumentException("Expected a valid error code", argument, "Check the argument type.");
+        } catch (const ParserException &e) {
+            rendered += e.getMessage().size();
+        }
+    }
+    double renderSeconds = renderTimer.seconds();
+
+    BENCHMARK_REPORT("throw and catch", discardSeconds * 1e9 / EXCEPTION_BENCHMARK_ITERATIONS, "ns/exception");
+    BENCHMARK_REPORT("throw, catch and render", renderSeconds * 1e9 / EXCEPTION_BENCHMARK_ITERATIONS, "ns/exception");
+    return (caught != EXCEPTION_BENCHMARK_ITERATIONS || rendered == 0);
+}
@@ -0,0 +1,52 @@
+#include "../config/jsonWriter.hpp"
+#include "test.hpp"
+
+static void testEscapes() {
+    CHECK(JsonWriter::escape("plain") == "plain");
+    CHECK(JsonWriter::escape("\"a\\b\"") == "\\\"a\\\\b\\\"");
+    CHECK(JsonWriter::escape("\n\t\r") == "\\n\\t\\r");
+    CHECK(JsonWriter::escape(std::string_view("\x01\0", 2)) == "\\u0001\\u0000");
+}
+
+/// @brief Well-formed UTF-8 is copied as it is, from the smallest to the largest code point of every length.
+static void testValidUtf8() {
+    CHECK(JsonWriter::escape("\xc2\x80 \xdf\xbf") == "\xc2\x80 \xdf\xbf");
+    CHECK(JsonWriter::escape("\xe0\xa0\x80 caf\xc3\xa9 \xef\xbf\xbf") == "\xe0\xa0\x80 caf\xc3\xa9 \xef\xbf\xbf");
+    CHECK(JsonWriter::escape("\xed\x9f\xbf \xee\x80\x80") == "\xed\x9f\xbf \xee\x80\x80");
+    CHECK(JsonWriter::escape("\xf0\x90\x80\x80 \xf4\x8f\xbf\xbf") == "\xf0\x90\x80\x80 \xf4\x8f\xbf\xbf");
+}
+
+/// @brief Every byte that is not part of a well-formed sequence is replaced by U+FFFD, the bytes after it are kept.
+static void testInvalidUtf8() {
+    // Stray continuation bytes and bytes that never start a sequence.
+    CHECK(JsonWriter::escape("a\x80z") == "a\\ufffdz");
+    CHECK(JsonWriter::escape("\xfe\xff") == "\\ufffd\\ufffd");
+    // Overlong forms of '/' and U+07FF.
+    CHECK(JsonWriter::escape("\xc0\xaf") == "\\ufffd\\ufffd");
+    CHECK(JsonWriter::escape("\xe0\x9f\xbf") == "\\ufffd\\ufffd\\ufffd");
+    CHECK(JsonWriter::escape("\xf0\x8f\xbf\xbf") == "\\ufffd\\ufffd\\ufffd\\ufffd");
+    // The surrogate U+D800 and U+110000.
+    CHECK(JsonWriter::escape("\xed\xa0\x80") == "\\ufffd\\ufffd\\ufffd");
+    CHECK(JsonWriter::escape("\xf4\x90\x80\x80") == "\\ufffd\\ufffd\\ufffd\\ufffd");
+    // A truncated sequence, at the end of the string and before an ASCII character.
+    CHECK(JsonWriter::escape("\xe2\x82") == "\\ufffd\\ufffd");
+    CHECK(JsonWriter::escape("\xe2\x82\"") == "\\ufffd\\ufffd\\\"");
+}
+
+static void testDocument() {
+    JsonWriter json;
+
+    json.beginObject();
+    json.key("name").string("bad\xff");
+    json.key("list").beginArray().number(1).number(2.5).boolean(true).null().endArray();
+    json.endObject();
+    CHECK(json.str() == "{\"name\":\"bad\\ufffd\",\"list\":[1,2.5,true,null]}");
+}
+
+int main() {
+    testEscapes();
+    testValidUtf8();
+    testInvalidUtf8();
+    testDocument();
+    return (TEST_RESULT("jsonWriterTest"));
+}
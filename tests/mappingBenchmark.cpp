@@ -0,0 +1,45 @@
+#include "allocationCounter.hpp"
+#include "benchmark.hpp"
+#include "test.hpp"
+
+#include <array>
+
+#define MAPPING_BENCHMARK_ITERATIONS 1000000
+
+/// @brief Normalize a URL in the buffer, then route and map that path in place.
+static size_t mapUrl(const ServerConfig &server, std::string_view url, std::span<char> buffer) {
+    size_t length = Path::normalizeUrl(url, buffer);
+    if (length == std::string::npos)
+        return (0);
+
+    std::string_view path(buffer.data(), length);
+    return (Path::createFromPath(path, server.getLocation(path), buffer));
+}
+
+/// @brief Map URLs to filesystem paths, and report the throughput and the heap allocations per mapping.
+int main() {
+    Logger::setLevel(LogLevel::ERROR);
+    std::vector<ServerConfig> servers = loadServers("tests/configs/router.conf");
+    if (servers.size() != 1)
+        return (1);
+
+    const ServerConfig &server = servers[0];
+    const char *urls[] = {"/static/css/site.css", "/static/images/logo.png", "/api/v1/users/42", "/index.html"};
+    std::array<char, 4096> buffer;
+    size_t checksum = 0;
+
+    // The first lookup of a thread sizes its scratch space for the regex router.
+    for (const char *url : urls)
+        checksum += mapUrl(server, url, buffer);
+
+    AllocationCounter counter;
+    BenchmarkTimer timer;
+    for (size_t i = 0; i < MAPPING_BENCHMARK_ITERATIONS; ++i)
+        checksum += mapUrl(server, urls[i % std::size(urls)], buffer);
+    double seconds = timer.seconds();
+    size_t allocations = counter.count();
+
+    BENCHMARK_REPORT("mapping", MAPPING_BENCHMARK_ITERATIONS / seconds, "mappings/s");
+    BENCHMARK_REPORT("mapping", static_cast<double>(allocations) / MAPPING_BENCHMARK_ITERATIONS, "allocations/mapping");
+    return (checksum == 0 || allocations != 0);
+}
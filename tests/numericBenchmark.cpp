@@ -0,0 +1,45 @@
+#include "benchmark.hpp"
+#include "test.hpp"
+
+#include <unistd.h>
+#include <fstream>
+
+#define NUMERIC_BENCHMARK_ARGUMENTS 100000
+#define NUMERIC_BENCHMARK_ARGUMENTS_PER_RULE 100
+
+/// @brief Write a server whose error_page rules hold NUMERIC_BENCHMARK_ARGUMENTS status codes.
+static std::string writeNumericConfig() {
+    std::string filePath = "/tmp/numericBenchmark." + std::to_string(getpid()) + ".conf";
+    std::ofstream file(filePath);
+
+    file << "server {\n    listen 8080;\n    server_name numeric;\n    root var/www;\n";
+    for (size_t rule = 0; rule < NUMERIC_BENCHMARK_ARGUMENTS / NUMERIC_BENCHMARK_ARGUMENTS_PER_RULE; ++rule) {
+        file << "    error_page";
+        for (size_t i = 0; i < NUMERIC_BENCHMARK_ARGUMENTS_PER_RULE; ++i)
+            file << " " << 400 + (rule * NUMERIC_BENCHMARK_ARGUMENTS_PER_RULE + i) % 200;
+        file << " var/www/error.html;\n";
+    }
+    file << "}\n";
+    return (filePath);
+}
+
+/// @brief Parse and build a configuration with 100k numeric arguments, and report the conversion throughput.
+int main() {
+    Logger::setLevel(LogLevel::ERROR);
+    std::string filePath = writeNumericConfig();
+    ConfigurationParser parser;
+
+    BenchmarkTimer parseTimer;
+    bool parsed = parser.parseFile(filePath);
+    double parseSeconds = parseTimer.seconds();
+
+    BenchmarkTimer buildTimer;
+    std::vector<ServerConfig> servers = parser.getResult(filePath);
+    double buildSeconds = buildTimer.seconds();
+    unlink(filePath.c_str());
+
+    BENCHMARK_REPORT("numeric arguments", parseSeconds * 1000, "ms to parse");
+    BENCHMARK_REPORT("numeric arguments", buildSeconds * 1000, "ms to build");
+    BENCHMARK_REPORT("numeric arguments", NUMERIC_BENCHMARK_ARGUMENTS / buildSeconds, "arguments/s");
+    return (!parsed || servers.size() != 1);
+}
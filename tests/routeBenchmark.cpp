@@ -0,0 +1,46 @@
+#include "benchmark.hpp"
+#include "test.hpp"
+
+#include <unistd.h>
+#include <fstream>
+
+#define ROUTE_BENCHMARK_LOCATIONS 200
+#define ROUTE_BENCHMARK_ITERATIONS 1000000
+
+/// @brief Write a server with nested prefix locations, and a few exact and regex ones.
+static std::string writeRouteConfig() {
+    std::string filePath = "/tmp/routeBenchmark." + std::to_string(getpid()) + ".conf";
+    std::ofstream file(filePath);
+
+    file << "server {\n    listen 8080;\n    server_name route;\n    root var/www;\n";
+    for (size_t i = 0; i < ROUTE_BENCHMARK_LOCATIONS; ++i) {
+        file << "    location /section" << i % 20 << (i < 20 ? "" : "/page" + std::to_string(i)) << " {\n"
+            << "        root var/www/" << i << ";\n        index index.html;\n        autoindex on;\n    }\n";
+    }
+    file << "    location = /favicon.ico {\n        root var/www/static;\n    }\n"
+        << "    location ~ \\.php$ {\n        root var/www/php;\n        cgi on;\n    }\n}\n";
+    return (filePath);
+}
+
+/// @brief Route normalized paths through the exact, regex and prefix locations of a server, and report the lookups per second.
+int main() {
+    Logger::setLevel(LogLevel::ERROR);
+    std::string filePath = writeRouteConfig();
+    std::vector<ServerConfig> servers = loadServers(filePath);
+    unlink(filePath.c_str());
+    if (servers.size() != 1)
+        return (1);
+
+    const ServerConfig &server = servers[0];
+    const char *paths[] = {"/section3/page43/image.png", "/section7/index.html", "/favicon.ico", "/section1/page181/a.php",
+        "/unknown/path", "/section19/page199"};
+    size_t checksum = 0;
+
+    BenchmarkTimer timer;
+    for (size_t i = 0; i < ROUTE_BENCHMARK_ITERATIONS; ++i)
+        checksum += server.getRoute(paths[i % std::size(paths)]).locationIndex;
+    double seconds = timer.seconds();
+
+    BENCHMARK_REPORT("route lookup", ROUTE_BENCHMARK_ITERATIONS / seconds, "lookups/s");
+    return (checksum == 0);
+}
@@ -0,0 +1,102 @@
+#include "../config/types/regexAutomaton.hpp"
+#include "test.hpp"
+
+#include <pthread.h>
+
+#define ROUTER_TEST_STACK_SIZE (256 * 1024)
+#define ROUTER_TEST_LONG_URL_LENGTH 100000
+
+static std::string_view routedRoot(const ServerConfig &server, std::string_view url) {
+    return (server.getRoute(url).root);
+}
+
+static void testLookupOrder(const ServerConfig &server) {
+    CHECK(routedRoot(server, "/exact") == "var/www/exact");
+    CHECK(routedRoot(server, "/exact/") == "var/www/html");
+    CHECK(routedRoot(server, "/static/index.php") == "var/www/php");
+    CHECK(routedRoot(server, "/api/v2/index.php") == "var/www/php");
+    CHECK(routedRoot(server, "/api/v2/users") == "var/www/api");
+    CHECK(routedRoot(server, "/static/images/logo.png") == "var/www/images");
+    CHECK(routedRoot(server, "/static/style.css") == "var/www/static");
+    CHECK(routedRoot(server, "/other") == "var/www/html");
+}
+
+/// @brief Normalize a URL once, then route and map that same path.
+static std::string mappedPath(const ServerConfig &server, std::string_view url) {
+    char buffer[4096];
+
+    size_t length = Path::normalizeUrl(url, buffer);
+    if (length == std::string::npos)
+        return ("");
+    std::string_view path(buffer, length);
+    length = Path::createFromPath(path, server.getLocation(path), buffer);
+    return (length == std::string::npos ? "" : std::string(buffer, length));
+}
+
+/// @brief The location is chosen for the normalized path, so an encoded or non-canonical URL gets the rules of the file it maps to.
+static void testNormalizedRouting(const ServerConfig &server) {
+    CHECK(mappedPath(server, "/static/x") == "var/www/static/x");
+    CHECK(mappedPath(server, "//static//x") == "var/www/static/x");
+    CHECK(mappedPath(server, "/%73tatic/x") == "var/www/static/x");
+    CHECK(mappedPath(server, "/static/./images/logo.png") == "var/www/images/logo.png");
+    CHECK(mappedPath(server, "/static/../www") == "var/www/html/www");
+    CHECK(mappedPath(server, "/%65xact?query") == "var/www/exact");
+    CHECK(mappedPath(server, "/static/../../etc/passwd") == "");
+}
+
+static void testAutomaton() {
+    RegexAutomaton automaton;
+    std::string error;
+
+    CHECK(automaton.add("\\.php$", error));
+    CHECK(automaton.add("^/img/.*\\.(png|jpe?g)$", error));
+    CHECK(automaton.add("\\bword\\b", error));
+    CHECK(automaton.firstMatch("/index.php") == 0);
+    CHECK(automaton.firstMatch("/img/a/b.jpeg") == 1);
+    CHECK(automaton.firstMatch("/img/a.php") == 0);
+    CHECK(automaton.firstMatch("/a word here") == 2);
+    CHECK(automaton.firstMatch("/swordfish") == RegexAutomaton::NO_MATCH);
+
+    CHECK(!RegexAutomaton::validate("(a)\\1", error));
+    CHECK(!RegexAutomaton::validate("(?=a)", error));
+    CHECK(!RegexAutomaton::validate("a{2,1}", error));
+    CHECK(!RegexAutomaton::validate("[a", error));
+    CHECK(automaton.getPatternCount() == 3);
+}
+
+/// @brief Route very long URLs on a thread with a small stack: matching must not recurse per character.
+static void *routeLongUrls(void *argument) {
+    const ServerConfig &server = *static_cast<const ServerConfig *>(argument);
+    std::string url = "/" + std::string(ROUTER_TEST_LONG_URL_LENGTH, 'a');
+
+    CHECK(routedRoot(server, url) == "var/www/html");
+    CHECK(routedRoot(server, url + "b") == "var/www/backtrack");
+    CHECK(routedRoot(server, url + ".php") == "var/www/php");
+    CHECK(routedRoot(server, "/static/" + url) == "var/www/static");
+    return (nullptr);
+}
+
+static void testLongUrls(const ServerConfig &server) {
+    pthread_attr_t attributes;
+    pthread_t thread;
+
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, ROUTER_TEST_STACK_SIZE);
+    CHECK(pthread_create(&thread, &attributes, routeLongUrls, const_cast<ServerConfig *>(&server)) == 0);
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attributes);
+}
+
+int main() {
+    Logger::setLevel(LogLevel::ERROR);
+    std::vector<ServerConfig> servers = loadServers("tests/configs/router.conf");
+
+    CHECK(servers.size() == 1);
+    if (servers.size() == 1) {
+        testLookupOrder(servers[0]);
+        testLongUrls(servers[0]);
+        testNormalizedRouting(servers[0]);
+    }
+    testAutomaton();
+    return (TEST_RESULT("routerTest"));
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../config/rules/ruleTemplates/serverconfigRule.hpp"
+#include "../config/config.hpp"
+#include "../logger.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+/// @brief The number of failed checks of the test program.
+inline int &testFailures() {
+    static int failures = 0;
+    return (failures);
+}
+
+/// @brief Report a failed check with its location, and keep running the other checks.
+#define CHECK(expression) do { \
+        if (!(expression)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #expression << std::endl; \
+            ++testFailures(); \
+        } \
+    } while (0)
+
+/// @brief Print the result of the test program and return its exit code.
+#define TEST_RESULT(name) (std::cout << (testFailures() ? "\033[1;31m[FAIL] " : "\033[1;32m[ OK ] ") << (name) \
+    << "\033[0m" << std::endl, testFailures() ? 1 : 0)
+
+/// @brief Parse a configuration file and build its servers.
+inline std::vector<ServerConfig> loadServers(const std::string &filePath) {
+    ConfigurationParser parser;
+    if (!parser.parseFile(filePath))
+        return {};
+    return (parser.getResult(filePath));
+}